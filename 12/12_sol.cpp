@@ -1,41 +1,38 @@
 #include <vector>
-#include <map>
 #include <string>
-#include <memory>
 #include <algorithm>
 #include <iostream>
+#include <cstdint>
+#include <unordered_map>
+#include <functional>
 
 #include "../utility.h"
+#include "cave_graph.h"
 
-using t_cavern_id = std::string;
-
-struct Cavern
-{
-    t_cavern_id m_id;
-    bool m_is_large;
-    Cavern(t_cavern_id id, bool is_large) : m_id{id}, m_is_large{is_large} {};
-    bool operator==(const Cavern& cave) const {return this->m_id == cave.m_id;};
-};
-using t_cavern_map = std::map<t_cavern_id, std::vector<std::shared_ptr<Cavern>>>;
+// receives each found path as sequence of cave ids from start to end
+using t_path_sink = std::function<void(const std::vector<t_cave_id>&)>;
 
 // function declarations
-t_cavern_map read_cavern_map(const std::string& file_path, const std::string& start="start", const std::string& end="end");
-void print_cavern_map(const t_cavern_map& cavern_map);
-unsigned int calc_paths(const t_cavern_map& cavern_map, const std::string& start="start", const std::string& end="end");
-unsigned int calc_path_rec(const t_cavern_map& cavern_map, std::vector<t_cavern_id> path, std::shared_ptr<Cavern> cur_cavern, unsigned int& num_paths, const t_cavern_id& start, const t_cavern_id& end, bool small_cave_joker);
+CaveGraph read_cavern_map(const std::string& file_path);
+void print_cavern_map(const CaveGraph& cave_graph);
+std::uint64_t calc_paths(const CaveGraph& cave_graph, const std::string& start="start", const std::string& end="end", const bool small_cave_joker=true, const t_path_sink& sink={});
+std::uint64_t calc_paths_parallel(const CaveGraph& cave_graph, const size_t num_threads, const std::string& start="start", const std::string& end="end", const bool small_cave_joker=true, const t_path_sink& sink={});
+void calc_path_rec(const CaveGraph& cave_graph, std::vector<t_cave_id>& path, std::vector<std::uint32_t>& num_visits, std::uint64_t& num_paths, const t_cave_id start, const t_cave_id end, bool small_cave_joker, const t_path_sink& sink);
+std::uint64_t count_paths(const CaveGraph& cave_graph, const std::string& start="start", const std::string& end="end", const bool small_cave_joker=true);
+bool may_enter_cave(const CaveGraph& cave_graph, const t_cave_id cave, const bool already_visited, bool& small_cave_joker);
 
 
-unsigned int get_num_paths(const std::string& file_path)
-{ 
-    t_cavern_map cavern_map = read_cavern_map(file_path);
-    // print_cavern_map(cavern_map);
-    return calc_paths(cavern_map);
+std::uint64_t get_num_paths(const std::string& file_path, const bool small_cave_joker=true)
+{
+    CaveGraph cave_graph = read_cavern_map(file_path);
+    // print_cavern_map(cave_graph);
+    return count_paths(cave_graph, "start", "end", small_cave_joker);
 }
 
-t_cavern_map read_cavern_map(const std::string& file_path, const std::string& start, const std::string& end)
+CaveGraph read_cavern_map(const std::string& file_path)
 {
     std::vector<std::string> cavern_vec = read_string_vec_from_file(file_path);
-    t_cavern_map cavern_map;
+    std::vector<std::pair<std::string, std::string>> connections;
     for (const auto& connection : cavern_vec)
     {
         std::vector<std::string> sub_str = split_string(connection, "-");
@@ -43,111 +40,302 @@ t_cavern_map read_cavern_map(const std::string& file_path, const std::string& st
         {
             continue;
         }
-        else 
+        else if (sub_str.size() != 2)
+        {
+            throw std::runtime_error("A connection must consist of a pair of strings!");
+        }
+        connections.emplace_back(sub_str[0], sub_str[1]);
+    }
+    return CaveGraph{ connections };
+}
+
+
+void print_cavern_map(const CaveGraph& cave_graph)
+{
+    std::cout << "\n";
+    for (t_cave_id cave=0; cave < cave_graph.num_caves(); ++cave)
+    {
+        for (const auto& connection : cave_graph.neighbors(cave))
         {
-            if (sub_str.size() != 2)
+            std::cout << cave_graph.name(cave) << " - " << cave_graph.name(connection) << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+// memoized path counter over interned cave ids, the state of a partial path is
+// (current cave, set of visited small caves, joker still available)
+class PathCounter
+{
+public:
+    PathCounter(const CaveGraph& cave_graph, const t_cave_id start, const t_cave_id end);
+    std::uint64_t count(const bool small_cave_joker);
+
+private:
+    static constexpr size_t MAX_SMALL_CAVES = 64u; ///< visited small caves are stored as bitmask
+
+    std::uint64_t count_rec(const t_cave_id cave, const std::uint64_t visited, const bool joker);
+
+    const CaveGraph& m_graph;
+    std::vector<std::uint64_t> m_small_bit; ///< bit of each small cave in the visited mask, 0 for large caves
+    t_cave_id m_start;
+    t_cave_id m_end;
+    std::vector<std::unordered_map<std::uint64_t, std::uint64_t>> m_memo; ///< [2 * cave + joker][visited] -> number of paths to end
+};
+
+PathCounter::PathCounter(const CaveGraph& cave_graph, const t_cave_id start, const t_cave_id end)
+    : m_graph{ cave_graph }, m_small_bit(cave_graph.num_caves(), 0u), m_start{ start }, m_end{ end }, m_memo(2u * cave_graph.num_caves())
+{
+    size_t num_small_caves{ 0 };
+    for (t_cave_id cave=0; cave < m_graph.num_caves(); ++cave)
+    {
+        if (!m_graph.is_large(cave))
+        {
+            if (num_small_caves == MAX_SMALL_CAVES)
             {
-                throw std::runtime_error("A connection must consist of a pair of strings!");
+                throw std::runtime_error("Too many small caverns for the path counter!");
             }
-            else
+            m_small_bit[cave] = std::uint64_t{1} << num_small_caves++;
+            continue;
+        }
+        for (const auto& next : m_graph.neighbors(cave))
+        {
+            if (m_graph.is_large(next))
             {
-                auto vec = cavern_map[sub_str[0]]; // should also construct new entry if it does not already exist
-                auto is_found_0 = [sub_str](std::shared_ptr<Cavern> cave){ return sub_str[0] == cave->m_id; };
-                auto is_found_1 = [sub_str](std::shared_ptr<Cavern> cave){ return sub_str[1] == cave->m_id; };
-                if (std::find_if(vec.begin(), vec.end(), is_found_1) == vec.end()) // connection does not exist
-                {
-                    bool is_large_cave = std::isupper(static_cast<unsigned char>(sub_str[1][0]));
-                    cavern_map[sub_str[0]].push_back(std::make_shared<Cavern>(sub_str[1], is_large_cave));
-                }
-                vec = cavern_map[sub_str[1]]; // should also construct new entry if it does not already exist
-                if (std::find_if(vec.begin(), vec.end(), is_found_0) == vec.end()) // connection does not exist
-                {
-                    bool is_large_cave = std::isupper(static_cast<unsigned char>(sub_str[0][0]));
-                    cavern_map[sub_str[1]].push_back(std::make_shared<Cavern>(sub_str[0], is_large_cave));
-                }
+                throw std::runtime_error("Connected large caverns lead to an infinite number of paths!");
             }
         }
     }
-    return cavern_map;
 }
 
+/**
+ * @brief Counts all paths from start to end
+ *
+ * @param small_cave_joker if true a single small cave (except start and end) may be visited twice per path
+ * @return std::uint64_t number of unique paths
+ */
+std::uint64_t PathCounter::count(const bool small_cave_joker)
+{
+    return count_rec(m_start, m_small_bit[m_start], small_cave_joker);
+}
 
-void print_cavern_map(const t_cavern_map& cavern_map)
+std::uint64_t PathCounter::count_rec(const t_cave_id cave, const std::uint64_t visited, const bool joker)
 {
-    std::cout << "\n";
-    for (const auto& elem : cavern_map)
+    if (cave == m_end)
+    {
+        return 1u;
+    }
+    auto &memo = m_memo[2u * cave + (joker ? 1u : 0u)];
+    if (auto res = memo.find(visited); res != memo.end())
     {
-        for (const auto& connection : elem.second)
+        return res->second;
+    }
+
+    std::uint64_t num_paths{ 0 };
+    for (const t_cave_id next : m_graph.neighbors(cave))
+    {
+        if (next == m_start)
+        {
+            continue;
+        }
+        if ((visited & m_small_bit[next]) == 0u) // large or not yet visited small cave
         {
-            std::cout << elem.first << " - " << connection->m_id << "\n";
+            num_paths += count_rec(next, visited | m_small_bit[next], joker);
+        }
+        else if (joker && next != m_end)
+        {
+            num_paths += count_rec(next, visited, false);
         }
     }
-    std::cout << "\n";
+    memo[visited] = num_paths;
+    return num_paths;
+}
+
+/**
+ * @brief Counts all paths from start to end with a memoized depth first search
+ *
+ * @param cave_graph graph storing all connections between caverns and a flag for small/large cavern
+ * @param start starting point
+ * @param end ending point
+ * @param small_cave_joker if true a single small cave (except start and end) may be visited twice per path
+ * @return std::uint64_t number of unique paths from start to end
+ */
+std::uint64_t count_paths(const CaveGraph& cave_graph, const std::string& start, const std::string& end, const bool small_cave_joker)
+{
+    PathCounter counter{ cave_graph, cave_graph.id(start), cave_graph.id(end) };
+    return counter.count(small_cave_joker);
 }
 
 /**
  * @brief Find all paths by starting at the endpoint and going backwards all possible
  * connections that lead to the startpoint
- * 
- * @param cavern_map map storing all connections between caverns and a flag for small/large cavern
- * @param start starting point 
+ *
+ * @param cave_graph graph storing all connections between caverns and a flag for small/large cavern
+ * @param start starting point
  * @param end ending point
- * @return unsigned int number of unique paths from start to end
+ * @param small_cave_joker if true a single small cave (except start and end) may be visited twice per path
+ * @param sink optional callback receiving every found path
+ * @return std::uint64_t number of unique paths from start to end
  */
-unsigned int calc_paths(const t_cavern_map& cavern_map, const t_cavern_id& start, const t_cavern_id& end)
+std::uint64_t calc_paths(const CaveGraph& cave_graph, const std::string& start, const std::string& end, const bool small_cave_joker, const t_path_sink& sink)
 {
-    std::vector<t_cavern_id> path{end};
-    unsigned int num_paths{0};
-    for (const auto& cavern : cavern_map.at(end)) 
+    const t_cave_id start_id = cave_graph.id(start);
+    const t_cave_id end_id = cave_graph.id(end);
+    std::vector<t_cave_id> path{end_id};
+    std::vector<std::uint32_t> num_visits(cave_graph.num_caves(), 0u);
+    num_visits[end_id] = 1u;
+    std::uint64_t num_paths{0};
+    for (const auto& cavern : cave_graph.neighbors(end_id))
     {
-        calc_path_rec(cavern_map, path, cavern, num_paths, start, end, true);
+        path.push_back(cavern);
+        calc_path_rec(cave_graph, path, num_visits, num_paths, start_id, end_id, small_cave_joker, sink);
+        path.pop_back();
     }
     return num_paths;
 }
 
+// partial path handed to the thread pool, path.back() is the cave to continue with
+struct PathTask
+{
+    std::vector<t_cave_id> path{};
+    bool small_cave_joker{ false };
+};
 
-unsigned int calc_path_rec(const t_cavern_map& cavern_map, std::vector<t_cavern_id> path, std::shared_ptr<Cavern> cur_cavern, unsigned int& num_paths, const t_cavern_id& start, const t_cavern_id& end, bool small_cave_joker)
+/**
+ * @brief Parallel version of calc_paths. The first levels of the search tree are expanded sequentially 
+ * until there are enough subtrees, which are then enumerated by a work stealing thread pool.
+ * Each thread counts its paths separately, the counts are summed up at the end.
+ *
+ * @param cave_graph graph storing all connections between caverns and a flag for small/large cavern
+ * @param num_threads number of threads (including the calling thread)
+ * @param start starting point
+ * @param end ending point
+ * @param small_cave_joker if true a single small cave (except start and end) may be visited twice per path
+ * @param sink optional callback receiving every found path, called concurrently from all threads
+ * @return std::uint64_t number of unique paths from start to end
+ */
+std::uint64_t calc_paths_parallel(const CaveGraph& cave_graph, const size_t num_threads, const std::string& start, const std::string& end, const bool small_cave_joker, const t_path_sink& sink)
 {
-    if (cur_cavern->m_id == start) // path from start to end found
-    {
-        path.push_back(cur_cavern->m_id);
-        return ++num_paths;
-    }
-    if (cur_cavern->m_id == end) 
+    constexpr size_t TASKS_PER_THREAD{ 16u }; // more subtrees than threads to balance their different sizes
+    constexpr size_t MAX_FORK_DEPTH{ 8u };
+    const t_cave_id start_id = cave_graph.id(start);
+    const t_cave_id end_id = cave_graph.id(end);
+    std::uint64_t num_paths{0};
+    std::vector<std::uint32_t> num_visits(cave_graph.num_caves(), 0u);
+
+    // expand the search tree level by level, paths already ending at start are counted directly
+    std::vector<PathTask> tasks;
+    for (const auto& cavern : cave_graph.neighbors(end_id))
     {
-        return num_paths;
+        tasks.push_back({ {end_id, cavern}, small_cave_joker });
     }
-    if (std::find(path.begin(), path.end(), cur_cavern->m_id) != path.end()) // cavern already visited in current travel
+    for (size_t depth=0; depth < MAX_FORK_DEPTH && !tasks.empty() && tasks.size() < TASKS_PER_THREAD * num_threads; ++depth)
     {
-        if (!cur_cavern->m_is_large) // small cavern that has already been visited 
+        std::vector<PathTask> new_tasks;
+        for (auto& task : tasks)
         {
-            if (small_cave_joker) // only one small cavern can be visited twice per route
+            const t_cave_id cur_cavern = task.path.back();
+            if (cur_cavern == start_id)
             {
-                path.push_back(cur_cavern->m_id);
-                for (const auto& cavern : cavern_map.at(cur_cavern->m_id)) 
-                {
-                    calc_path_rec(cavern_map, path, cavern, num_paths, start, end, false);
-                }
+                calc_path_rec(cave_graph, task.path, num_visits, num_paths, start_id, end_id, task.small_cave_joker, sink);
+                continue;
             }
-            return num_paths;
-        }
-        else
-        {
-            path.push_back(cur_cavern->m_id);
-            for (const auto& cavern : cavern_map.at(cur_cavern->m_id)) 
+            if (cur_cavern == end_id)
+            {
+                continue;
+            }
+            bool joker = task.small_cave_joker;
+            if (!may_enter_cave(cave_graph, cur_cavern, std::find(task.path.begin(), task.path.end() - 1, cur_cavern) != task.path.end() - 1, joker))
+            {
+                continue;
+            }
+            for (const auto& cavern : cave_graph.neighbors(cur_cavern))
             {
-                calc_path_rec(cavern_map, path, cavern, num_paths, start, end, small_cave_joker);
+                PathTask new_task{ task.path, joker };
+                new_task.path.push_back(cavern);
+                new_tasks.push_back(std::move(new_task));
             }
-            return num_paths;
         }
+        tasks = std::move(new_tasks);
+    }
+
+    struct alignas(64) ThreadCount // one cache line per thread
+    {
+        std::uint64_t num_paths{ 0 };
+    };
+    std::vector<ThreadCount> thread_counts(num_threads);
+    std::function<void(PathTask&, const size_t)> worker = [&](PathTask& task, const size_t thread_idx)
+    {
+        std::vector<std::uint32_t> task_visits(cave_graph.num_caves(), 0u);
+        for (size_t i=0; i+1 < task.path.size(); ++i)
+        {
+            ++task_visits[task.path[i]];
+        }
+        calc_path_rec(cave_graph, task.path, task_visits, thread_counts[thread_idx].num_paths, start_id, end_id, task.small_cave_joker, sink);
+    };
+    run_work_stealing(std::move(tasks), num_threads, worker);
+
+    for (const auto& count : thread_counts)
+    {
+        num_paths += count.num_paths;
     }
-    else // new cavern 
+    return num_paths;
+}
+
+/**
+ * @brief Continues the path whose last cave is path.back(), visits of the caves before it are counted in num_visits
+ */
+void calc_path_rec(const CaveGraph& cave_graph, std::vector<t_cave_id>& path, std::vector<std::uint32_t>& num_visits, std::uint64_t& num_paths, const t_cave_id start, const t_cave_id end, bool small_cave_joker, const t_path_sink& sink)
+{
+    const t_cave_id cur_cavern = path.back();
+    if (cur_cavern == start) // path from start to end found
     {
-        path.push_back(cur_cavern->m_id);
-        for (const auto& cavern : cavern_map.at(cur_cavern->m_id)) 
+        ++num_paths;
+        if (sink)
         {
-            calc_path_rec(cavern_map, path, cavern, num_paths, start, end, small_cave_joker);
+            sink(std::vector<t_cave_id>(path.rbegin(), path.rend()));
         }
-        return num_paths;
+        return;
+    }
+    if (cur_cavern == end)
+    {
+        return;
+    }
+    if (!may_enter_cave(cave_graph, cur_cavern, num_visits[cur_cavern] > 0u, small_cave_joker))
+    {
+        return;
+    }
+
+    ++num_visits[cur_cavern];
+    for (const auto& cavern : cave_graph.neighbors(cur_cavern))
+    {
+        path.push_back(cavern);
+        calc_path_rec(cave_graph, path, num_visits, num_paths, start, end, small_cave_joker, sink);
+        path.pop_back();
+    }
+    --num_visits[cur_cavern];
+}
+
+/**
+ * @brief Decides if a path may continue with the given cave, a small cave that has already been visited
+ * consumes the joker (only one small cave can be visited twice per route)
+ *
+ * @param cave_graph graph storing all connections between caverns and a flag for small/large cavern
+ * @param cave cave to enter
+ * @param already_visited true if the path already contains the cave
+ * @param small_cave_joker joker of the path, reset if it is used
+ * @return true if the cave may be entered
+ */
+bool may_enter_cave(const CaveGraph& cave_graph, const t_cave_id cave, const bool already_visited, bool& small_cave_joker)
+{
+    if (!already_visited || cave_graph.is_large(cave))
+    {
+        return true;
+    }
+    if (!small_cave_joker)
+    {
+        return false;
     }
+    small_cave_joker = false;
+    return true;
 }
@@ -0,0 +1,131 @@
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cctype>
+#include <utility>
+
+using t_cave_id = std::uint32_t;
+
+/**
+ * @brief Undirected cave graph with interned integer ids stored in compressed sparse row format.
+ * The neighbors of cave i are m_targets[m_offsets[i]] ... m_targets[m_offsets[i+1]-1], sorted by id.
+ * Caves named in upper case are large, this is stored as bitset.
+ */
+class CaveGraph
+{
+public:
+    // contiguous range of neighbor ids
+    struct Neighbors
+    {
+        const t_cave_id *first;
+        const t_cave_id *last;
+        const t_cave_id *begin() const { return first; };
+        const t_cave_id *end() const { return last; };
+        size_t size() const { return static_cast<size_t>(last - first); };
+    };
+
+    explicit CaveGraph(const std::vector<std::pair<std::string, std::string>> &connections);
+    size_t num_caves() const;
+    t_cave_id id(const std::string &name) const;
+    const std::string &name(const t_cave_id cave) const;
+    Neighbors neighbors(const t_cave_id cave) const;
+    bool is_large(const t_cave_id cave) const;
+
+private:
+    std::vector<std::string> m_names; ///< name of each cave id
+    std::unordered_map<std::string, t_cave_id> m_ids; ///< cave id of each name
+    std::vector<size_t> m_offsets; ///< start of the neighbors of each cave in m_targets, num_caves+1 entries
+    std::vector<t_cave_id> m_targets; ///< neighbor ids of all caves
+    std::vector<std::uint64_t> m_is_large; ///< bit i%64 of word i/64 is set if cave i is large
+};
+
+/**
+ * @brief Builds the graph from a list of connections, cave ids are given in order of first appearance.
+ * Duplicated connections are stored only once.
+ *
+ * @param connections pairs of cave names
+ */
+CaveGraph::CaveGraph(const std::vector<std::pair<std::string, std::string>> &connections)
+{
+    auto intern = [this](const std::string &name){
+        if (name.empty())
+        {
+            throw std::invalid_argument("Cave name must not be empty!");
+        }
+        auto res = m_ids.emplace(name, static_cast<t_cave_id>(m_names.size()));
+        if (res.second)
+        {
+            m_names.push_back(name);
+        }
+        return res.first->second;
+    };
+
+    std::vector<std::pair<t_cave_id, t_cave_id>> edges;
+    edges.reserve(2u * connections.size());
+    for (const auto &connection : connections)
+    {
+        t_cave_id a = intern(connection.first);
+        t_cave_id b = intern(connection.second);
+        edges.emplace_back(a, b);
+        edges.emplace_back(b, a);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    m_offsets.assign(m_names.size() + 1u, 0u);
+    for (const auto &edge : edges)
+    {
+        ++m_offsets[edge.first + 1u];
+    }
+    for (size_t cave=0; cave < m_names.size(); ++cave)
+    {
+        m_offsets[cave + 1u] += m_offsets[cave];
+    }
+    m_targets.reserve(edges.size());
+    for (const auto &edge : edges) // edges are sorted by source, so targets are appended in CSR order
+    {
+        m_targets.push_back(edge.second);
+    }
+
+    m_is_large.assign((m_names.size() + 63u) / 64u, 0u);
+    for (size_t cave=0; cave < m_names.size(); ++cave)
+    {
+        if (std::isupper(static_cast<unsigned char>(m_names[cave][0])))
+        {
+            m_is_large[cave / 64u] |= std::uint64_t{1} << (cave % 64u);
+        }
+    }
+}
+
+size_t CaveGraph::num_caves() const
+{
+    return m_names.size();
+}
+
+t_cave_id CaveGraph::id(const std::string &name) const
+{
+    auto res = m_ids.find(name);
+    if (res == m_ids.end())
+    {
+        throw std::invalid_argument("Cave " + name + " not part of the cave graph!");
+    }
+    return res->second;
+}
+
+const std::string &CaveGraph::name(const t_cave_id cave) const
+{
+    return m_names.at(cave);
+}
+
+CaveGraph::Neighbors CaveGraph::neighbors(const t_cave_id cave) const
+{
+    return { m_targets.data() + m_offsets[cave], m_targets.data() + m_offsets[cave + 1u] };
+}
+
+bool CaveGraph::is_large(const t_cave_id cave) const
+{
+    return (m_is_large[cave / 64u] >> (cave % 64u)) & 1u;
+}
@@ -4,13 +4,16 @@
 #include <limits>
 #include <algorithm>
 #include <memory>
+#include <random>
+#include <stdexcept>
 
 #include "../utility.h"
-#include "sorted_queue.h"
+#include "priority_queue.h"
 
-constexpr size_t FIELD_SIZE = 100;
 constexpr size_t EXT_FACTOR = 5;
-constexpr size_t FIELD_SIZE_2 = FIELD_SIZE * EXT_FACTOR;
+constexpr std::uint32_t MIN_WEIGHT = 1;
+constexpr std::uint32_t MAX_WEIGHT = 9;
+constexpr std::array<std::pair<int, int>, 4> NEIGHBOR_OFFSETS{{{0,-1}, {0,1}, {-1,0}, {1,0}}};
 
 template<typename T, typename U>
 struct DijkstraPt : Point<T>
@@ -49,206 +52,333 @@ bool DijkstraPt<T,U>::operator==(const Point<T> &other) const
 using tCoord = std::uint32_t;
 using tWeight = std::uint32_t;
 using tPoint = DijkstraPt<tCoord, tWeight>;
-template<size_t ArraySize>
-using t2dShortestPathArr = std::array<std::array<tPoint, ArraySize>, ArraySize>;
-template<size_t ArraySize>
-using t2dWeightArr = std::array<std::array<tCoord, ArraySize>, ArraySize>;
-using tReachablePts = std::vector<tPoint*>;
+using tShortestPathGrid = Grid2D<tPoint>;
+using tWeightGrid = Grid2D<tWeight>;
+using tHeapQueue = QuaternaryHeap<tWeight>;
+using tBucketQueue = BucketQueue<tWeight>;
+
+/**
+ * @brief Read-only view of a map that is repeated tile_factor times in both directions.
+ * Each repetition to the right or downwards increases the risk by one (values above 9 wrap back to 1).
+ * Weights are computed on access, so only the memory of the original tile is used.
+ */
+class TiledWeightView
+{
+public:
+    TiledWeightView(const tWeightGrid &tile, const size_t tile_factor) : m_tile{tile}, m_tile_factor{tile_factor} {};
+    size_t rows() const { return m_tile.rows() * m_tile_factor; };
+    size_t cols() const { return m_tile.cols() * m_tile_factor; };
+    tWeight operator()(const size_t row, const size_t col) const;
+
+private:
+    const tWeightGrid &m_tile;
+    const size_t m_tile_factor;
+};
+
+tWeight TiledWeightView::operator()(const size_t row, const size_t col) const
+{
+    size_t tile_row = row / m_tile.rows();
+    size_t tile_col = col / m_tile.cols();
+    tWeight w = m_tile(row - tile_row * m_tile.rows(), col - tile_col * m_tile.cols());
+    return static_cast<tWeight>((w + tile_row + tile_col - 1) % MAX_WEIGHT + 1);
+}
+
+enum class SearchMode : std::uint8_t
+{
+    DIJKSTRA,
+    A_STAR,
+    BIDIRECTIONAL
+};
+
+struct SearchStats
+{
+    std::uint64_t num_expanded{ 0 }; ///< number of points taken from the queue(s) and marked as visited
+};
+
+/**
+ * @brief Heuristic of plain Dijkstra search, i.e. no estimate of the remaining distance
+ */
+struct NoHeuristic
+{
+    tWeight operator()(const tCoord /*x*/, const tCoord /*y*/) const { return 0; };
+};
+
+/**
+ * @brief Admissible and consistent A* heuristic: each remaining step to the target costs at least MIN_WEIGHT
+ */
+struct ManhattanHeuristic
+{
+    Point<tCoord> target;
+    tWeight operator()(const tCoord x, const tCoord y) const;
+};
+
+tWeight ManhattanHeuristic::operator()(const tCoord x, const tCoord y) const
+{
+    tCoord dx = x > target.x ? x - target.x : target.x - x;
+    tCoord dy = y > target.y ? y - target.y : target.y - y;
+    return (dx + dy) * MIN_WEIGHT;
+}
 
 // Function declarations
-template<size_t ArraySize>
-void update_not_visited_neighbors(tReachablePts &reachable_pts, t2dShortestPathArr<ArraySize> &shortest_path, tPoint next_pt, const t2dShortestPathArr<ArraySize> &weights);
-template<size_t ArraySize>
-bool update_DijkstraPt(tPoint pt, t2dShortestPathArr<ArraySize> & shortest_paths, tReachablePts &reachable_pts);
-template<size_t ArraySize>
-const t2dShortestPathArr<ArraySize> get_shortest_path(Point<tCoord> start, Point<tCoord> end, t2dWeightArr<ArraySize> weights);
-void sort(tReachablePts &tReachablePts);
-template<size_t ArraySize>
-void vertical_ext(t2dWeightArr<ArraySize> &weights);
-template<size_t ArraySize>
-void horizontal_ext(t2dWeightArr<ArraySize> &weights);
-
-std::uint32_t calc_lowest_risk(const std::string& file_path)
-{
-    std::vector<std::vector<tCoord>> chiton_vec = read_2d_vec_from_file<tCoord>(file_path);
-    t2dWeightArr<FIELD_SIZE> chiton_arr;
-    for (size_t row=0; row < chiton_vec.size(); ++row)
-    {
-        std::copy_n(chiton_vec[row].begin(), chiton_vec[0].size(), chiton_arr[row].begin());
-    }
+template<typename Queue, typename WeightMap, typename Heuristic>
+void update_not_visited_neighbors(Queue &reachable_pts, tShortestPathGrid &shortest_path, const tPoint &cur_pt, const WeightMap &weights, const Heuristic &heuristic, const bool reverse);
+template<typename Queue>
+void update_DijkstraPt(const tPoint &pt, tShortestPathGrid &shortest_paths, Queue &reachable_pts, const tWeight key);
+template<typename Queue = tHeapQueue, typename WeightMap, typename Heuristic = NoHeuristic>
+tShortestPathGrid get_shortest_path(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, SearchStats &stats, const Heuristic &heuristic = Heuristic{});
+template<typename Queue = tHeapQueue, typename WeightMap>
+tWeight get_lowest_risk_bidirectional(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, SearchStats &stats);
+template<typename Queue = tHeapQueue, typename WeightMap>
+tWeight get_lowest_risk(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, const SearchMode mode, SearchStats &stats);
+
+template<typename Queue = tHeapQueue>
+std::uint32_t calc_lowest_risk(const std::string& file_path, const SearchMode mode, SearchStats &stats)
+{
+    tWeightGrid chiton_grid = read_grid_from_file<tWeight>(file_path);
     Point<tCoord> start{0,0};
-    Point<tCoord> end{FIELD_SIZE-1, FIELD_SIZE-1};
-    t2dShortestPathArr<FIELD_SIZE> result = get_shortest_path<FIELD_SIZE>(start, end, chiton_arr);
-    return result[end.x][end.y].dist;
+    Point<tCoord> end{static_cast<tCoord>(chiton_grid.rows()-1), static_cast<tCoord>(chiton_grid.cols()-1)};
+    return get_lowest_risk<Queue>(start, end, chiton_grid, mode, stats);
+}
+
+template<typename Queue = tHeapQueue>
+std::uint32_t calc_lowest_risk(const std::string& file_path, const SearchMode mode = SearchMode::DIJKSTRA)
+{
+    SearchStats stats{};
+    return calc_lowest_risk<Queue>(file_path, mode, stats);
 }
 
 
-std::uint32_t calc_lowest_risk_2(const std::string& file_path)
+template<typename Queue = tHeapQueue>
+std::uint32_t calc_lowest_risk_2(const std::string& file_path, const size_t ext_factor, const SearchMode mode, SearchStats &stats)
 {
-    std::vector<std::vector<tCoord>> chiton_vec = read_2d_vec_from_file<tCoord>(file_path);
-    t2dWeightArr<FIELD_SIZE_2> chiton_arr;
-    for (size_t row=0; row < chiton_vec.size(); ++row)
-    {
-        std::copy_n(chiton_vec[row].begin(), chiton_vec[0].size(), chiton_arr[row].begin());
-    }
-    vertical_ext<FIELD_SIZE_2>(chiton_arr);
-    horizontal_ext<FIELD_SIZE_2>(chiton_arr);
+    tWeightGrid chiton_tile = read_grid_from_file<tWeight>(file_path);
+    TiledWeightView chiton_grid{chiton_tile, ext_factor};
     Point<tCoord> start{0,0};
-    Point<tCoord> end{chiton_arr.size()-1, chiton_arr.size()-1};
-    t2dShortestPathArr<FIELD_SIZE_2> result = get_shortest_path<FIELD_SIZE_2>(start, end, chiton_arr);
-    return result[end.x][end.y].dist;
+    Point<tCoord> end{static_cast<tCoord>(chiton_grid.rows()-1), static_cast<tCoord>(chiton_grid.cols()-1)};
+    return get_lowest_risk<Queue>(start, end, chiton_grid, mode, stats);
 }
 
-template<size_t ArraySize>
-void vertical_ext(t2dWeightArr<ArraySize> &weights)
+template<typename Queue = tHeapQueue>
+std::uint32_t calc_lowest_risk_2(const std::string& file_path, const size_t ext_factor = EXT_FACTOR, const SearchMode mode = SearchMode::DIJKSTRA)
 {
-    for (size_t row=FIELD_SIZE; row < weights.size(); ++row)
+    SearchStats stats{};
+    return calc_lowest_risk_2<Queue>(file_path, ext_factor, mode, stats);
+}
+
+/**
+ * @brief Checks every combination of search mode and queue engine against plain Dijkstra with the heap
+ * on random grids (plain and tiled weight maps), throws on the first differing result
+ * 
+ * @param num_grids number of random grids
+ * @param max_grid_size rows and cols are drawn from [1, max_grid_size]
+ * @param seed 
+ */
+void check_queue_engines(const size_t num_grids = 200u, const size_t max_grid_size = 8u, const std::uint32_t seed = 15u)
+{
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<size_t> size_dist{1u, max_grid_size};
+    std::uniform_int_distribution<tWeight> weight_dist{MIN_WEIGHT, MAX_WEIGHT};
+    for (size_t i=0; i<num_grids; ++i)
     {
-        for (size_t col=0; col < FIELD_SIZE; ++col)
+        tWeightGrid grid{size_dist(rng), size_dist(rng)};
+        for (size_t idx=0; idx<grid.size(); ++idx)
+        {
+            grid[idx] = weight_dist(rng);
+        }
+        TiledWeightView tiled_grid{grid, 2u};
+        SearchStats stats{};
+        Point<tCoord> end{static_cast<tCoord>(grid.rows()-1), static_cast<tCoord>(grid.cols()-1)};
+        Point<tCoord> tiled_end{static_cast<tCoord>(tiled_grid.rows()-1), static_cast<tCoord>(tiled_grid.cols()-1)};
+        const tWeight reference = get_lowest_risk<tHeapQueue>({0,0}, end, grid, SearchMode::DIJKSTRA, stats);
+        const tWeight tiled_reference = get_lowest_risk<tHeapQueue>({0,0}, tiled_end, tiled_grid, SearchMode::DIJKSTRA, stats);
+        for (const SearchMode mode : {SearchMode::DIJKSTRA, SearchMode::A_STAR, SearchMode::BIDIRECTIONAL})
         {
-            weights[row][col] = weights[row-FIELD_SIZE][col] + 1;
-            if (weights[row][col] == 10)
+            if (get_lowest_risk<tHeapQueue>({0,0}, end, grid, mode, stats) != reference
+                || get_lowest_risk<tBucketQueue>({0,0}, end, grid, mode, stats) != reference
+                || get_lowest_risk<tHeapQueue>({0,0}, tiled_end, tiled_grid, mode, stats) != tiled_reference
+                || get_lowest_risk<tBucketQueue>({0,0}, tiled_end, tiled_grid, mode, stats) != tiled_reference)
             {
-                weights[row][col] = 1;
+                throw std::runtime_error("Search mode " + std::to_string(static_cast<int>(mode)) + " differs from Dijkstra on random grid " + std::to_string(i) + "!");
             }
         }
     }
 }
 
-template<size_t ArraySize>
-void horizontal_ext(t2dWeightArr<ArraySize> &weights)
+/**
+ * @brief Calculates the lowest total risk of any path from start to end with the selected search mode
+ * 
+ * @tparam Queue priority queue engine (tHeapQueue or tBucketQueue)
+ * @tparam WeightMap tWeightGrid or TiledWeightView
+ * @param start 
+ * @param end 
+ * @param weights 
+ * @param mode Dijkstra, A* with Manhattan heuristic or bidirectional Dijkstra
+ * @param stats number of expanded points is added here
+ * @return tWeight 
+ */
+template<typename Queue, typename WeightMap>
+tWeight get_lowest_risk(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, const SearchMode mode, SearchStats &stats)
 {
-    for (size_t row=0; row < weights.size(); ++row)
+    switch(mode)
     {
-        for (size_t col=FIELD_SIZE; col < weights[0].size(); ++col)
-        {
-            weights[row][col] = weights[row][col-FIELD_SIZE] + 1;
-            if (weights[row][col] == 10)
-            {
-                weights[row][col] = 1;
-            }
-        }
+        case SearchMode::DIJKSTRA:
+            return get_shortest_path<Queue>(start, end, weights, stats)(end.x, end.y).dist;
+        case SearchMode::A_STAR:
+            return get_shortest_path<Queue>(start, end, weights, stats, ManhattanHeuristic{end})(end.x, end.y).dist;
+        case SearchMode::BIDIRECTIONAL:
+            return get_lowest_risk_bidirectional<Queue>(start, end, weights, stats);
+        default:
+            throw std::runtime_error("Unknown search mode received!");
     }
 }
 
-
-template<size_t ArraySize>
-const t2dShortestPathArr<ArraySize> get_shortest_path(Point<tCoord> start, Point<tCoord> end, t2dWeightArr<ArraySize> weights)
+/**
+ * @brief Dijkstra (or A* if a heuristic is given) search from start to end on a 2D grid of weights (4-neighborhood)
+ * 
+ * @tparam Queue priority queue engine providing push_or_decrease/pop_min on node ids (tHeapQueue or tBucketQueue)
+ * @tparam WeightMap tWeightGrid or any map providing rows(), cols() and operator()(row, col), e.g. TiledWeightView
+ * @tparam Heuristic NoHeuristic or a consistent estimate of the remaining distance, e.g. ManhattanHeuristic
+ * @param start 
+ * @param end 
+ * @param weights 
+ * @param stats number of expanded points is added here
+ * @param heuristic 
+ * @return tShortestPathGrid grid containing the distance and predecessor of each visited point
+ */
+template<typename Queue, typename WeightMap, typename Heuristic>
+tShortestPathGrid get_shortest_path(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, SearchStats &stats, const Heuristic &heuristic)
 {
-    t2dShortestPathArr<ArraySize> shortest_path{};
-    shortest_path[start.x][start.y] = tPoint(start.x, start.y, 0, true, true, Point<tCoord>{0,0});
-    tReachablePts reachable_pts{&shortest_path[start.x][start.y]}; // Init queue of reachable points with start point
+    tShortestPathGrid shortest_path{weights.rows(), weights.cols()};
+    shortest_path(start.x, start.y) = tPoint(start.x, start.y, 0, false, true, Point<tCoord>{0,0});
+    // With a consistent heuristic the key grows by at most MAX_WEIGHT + MIN_WEIGHT per step
+    Queue reachable_pts(shortest_path.size(), MAX_WEIGHT + MIN_WEIGHT); // Init queue of reachable points with start point
+    reachable_pts.push_or_decrease(shortest_path.index(start.x, start.y), heuristic(start.x, start.y));
     while (!reachable_pts.empty())
     {
-        auto next_pt = reachable_pts.back(); // get point with min dist to any of the already visited points
-        reachable_pts.pop_back();
-        next_pt->is_visited = true;
-        if (!(*next_pt == start))
-        {
-            next_pt->dist = weights[next_pt->x][next_pt->y] + shortest_path[next_pt->predecessor.x][next_pt->predecessor.y].dist;
-        }
+        tPoint &next_pt = shortest_path[reachable_pts.pop_min()]; // get point with min dist to any of the already visited points
+        next_pt.is_visited = true;
+        ++stats.num_expanded;
 
-        if (*next_pt == end) 
+        if (next_pt == end) 
         {
             break;
         }
-        update_not_visited_neighbors<ArraySize>(reachable_pts, shortest_path, *next_pt, weights);
+        update_not_visited_neighbors(reachable_pts, shortest_path, next_pt, weights, heuristic, false);
     }
     return shortest_path;
 }
 
-
 /**
- * @brief Adds not visited neighbors of current node/point to the queue of reachable points. 
+ * @brief Bidirectional Dijkstra search: alternately expands one point from start (forward) and from end (backward).
+ * Stops as soon as a point is visited by both searches. The result is the shortest path over all points reached by both searches.
  * 
- * @tparam ArraySize 
- * @param reachable_pts vector of pointers to reachable points that have not been visited yet
- * @param shortest_path 
- * @param cur_pt 
+ * @tparam Queue priority queue engine (tHeapQueue or tBucketQueue)
+ * @tparam WeightMap tWeightGrid or TiledWeightView
+ * @param start 
+ * @param end 
  * @param weights 
+ * @param stats number of expanded points (both directions) is added here
+ * @return tWeight lowest total risk from start to end
  */
-template<size_t ArraySize>
-void update_not_visited_neighbors(tReachablePts &reachable_pts, t2dShortestPathArr<ArraySize> &shortest_path, tPoint cur_pt, const t2dWeightArr<ArraySize> &weights)
+template<typename Queue, typename WeightMap>
+tWeight get_lowest_risk_bidirectional(Point<tCoord> start, Point<tCoord> end, const WeightMap &weights, SearchStats &stats)
 {
-    tCoord cur_dist = shortest_path[cur_pt.x][cur_pt.y].dist; // Distance to cur_pt
-    bool above_exist = cur_pt.x > 0;
-    bool below_exist = cur_pt.x < ArraySize-1;
-    bool right_exist = cur_pt.y < ArraySize-1;
-    bool left_exist  = cur_pt.y > 0;
-
-    bool sorted{true};
-    if (left_exist && !shortest_path[cur_pt.x][cur_pt.y-1].is_visited)
-    {
-        // tPoint neighbor{cur_pt.x-1, cur_pt.x, weights[cur_pt.x-1][cur_pt.x] + cur_dist, cur_pt};
-        tPoint neighbor{cur_pt.x, cur_pt.y-1, weights[cur_pt.x][cur_pt.y-1] + cur_dist, false, true, cur_pt};
-        sorted = update_DijkstraPt(neighbor, shortest_path, reachable_pts) && sorted;
-    }
-    if (right_exist && !shortest_path[cur_pt.x][cur_pt.y+1].is_visited)
-    {
-        tPoint neighbor{cur_pt.x, cur_pt.y+1, weights[cur_pt.x][cur_pt.y+1] + cur_dist, false, true, cur_pt};
-        sorted = update_DijkstraPt(neighbor, shortest_path, reachable_pts) && sorted;
-    }
-    if (above_exist && !shortest_path[cur_pt.x-1][cur_pt.y].is_visited)
-    {
-        tPoint neighbor{cur_pt.x-1, cur_pt.y, weights[cur_pt.x-1][cur_pt.y] + cur_dist, false, true, cur_pt};
-        sorted = update_DijkstraPt(neighbor, shortest_path, reachable_pts) && sorted;
-    }
-    if (below_exist && !shortest_path[cur_pt.x+1][cur_pt.y].is_visited)
+    if (start == end)
     {
-        tPoint neighbor{cur_pt.x+1, cur_pt.y, weights[cur_pt.x+1][cur_pt.y] + cur_dist, false, true, cur_pt};
-        sorted = update_DijkstraPt(neighbor, shortest_path, reachable_pts) && sorted;
+        return 0;
     }
-    if (!sorted)
+    tShortestPathGrid forward_paths{weights.rows(), weights.cols()};
+    tShortestPathGrid backward_paths{weights.rows(), weights.cols()};
+    Queue forward_pts(forward_paths.size(), MAX_WEIGHT);
+    Queue backward_pts(backward_paths.size(), MAX_WEIGHT);
+    forward_paths(start.x, start.y) = tPoint(start.x, start.y, 0, false, true, Point<tCoord>{0,0});
+    forward_pts.push_or_decrease(forward_paths.index(start.x, start.y), 0);
+    backward_paths(end.x, end.y) = tPoint(end.x, end.y, 0, false, true, Point<tCoord>{0,0});
+    backward_pts.push_or_decrease(backward_paths.index(end.x, end.y), 0);
+
+    tWeight lowest_risk = std::numeric_limits<tWeight>::max();
+    bool forward{true};
+    while (!forward_pts.empty() && !backward_pts.empty())
     {
-        sort(reachable_pts);
+        Queue &reachable_pts = forward ? forward_pts : backward_pts;
+        tShortestPathGrid &own_paths = forward ? forward_paths : backward_paths;
+        const tShortestPathGrid &other_paths = forward ? backward_paths : forward_paths;
+
+        tPoint &next_pt = own_paths[reachable_pts.pop_min()];
+        next_pt.is_visited = true;
+        ++stats.num_expanded;
+        if (other_paths(next_pt.x, next_pt.y).is_visited) 
+        {
+            break;
+        }
+        update_not_visited_neighbors(reachable_pts, own_paths, next_pt, weights, NoHeuristic{}, !forward);
+
+        // Forward distances contain the weight of the point itself, backward distances don't, so both can be added
+        for (const auto &offset : NEIGHBOR_OFFSETS)
+        {
+            tCoord x = next_pt.x + offset.first;
+            tCoord y = next_pt.y + offset.second;
+            if (x >= weights.rows() || y >= weights.cols()) // negative offsets wrap around
+            {
+                continue;
+            }
+            const tPoint &own_pt = own_paths(x, y);
+            const tPoint &other_pt = other_paths(x, y);
+            if (own_pt.is_reachable && other_pt.is_reachable && own_pt.dist + other_pt.dist < lowest_risk)
+            {
+                lowest_risk = own_pt.dist + other_pt.dist;
+            }
+        }
+        forward = !forward;
     }
+    return lowest_risk;
 }
 
+
 /**
- * @brief Update or add point with coord [x,y] to the priority queue if the point has not been visited yet
+ * @brief Adds not visited neighbors of current node/point to the queue of reachable points. 
  * 
- * @tparam ArraySize 
- * @param pt can be seen as a path to reach coordinate [pt.x, pt.y]
- * @param shortest_paths 2D-array of points
- * @param reachable_pts queue of reachable points
- * @return true if the queue of reachable points was not modified and the queue is still sorted
- * @return false if the queue was modified, either by adding a new point or changing a existing one
+ * @param reachable_pts priority queue of reachable points that have not been visited yet
+ * @param shortest_path 
+ * @param cur_pt 
+ * @param weights 
+ * @param heuristic added to the distance of a point to get its key in the queue
+ * @param reverse if true, a step costs the weight of the point that is left (backward search) instead of the point that is entered
  */
-template<size_t ArraySize>
-bool update_DijkstraPt(tPoint pt, t2dShortestPathArr<ArraySize> &shortest_paths, tReachablePts &reachable_pts)
+template<typename Queue, typename WeightMap, typename Heuristic>
+void update_not_visited_neighbors(Queue &reachable_pts, tShortestPathGrid &shortest_path, const tPoint &cur_pt, const WeightMap &weights, const Heuristic &heuristic, const bool reverse)
 {
-    tPoint& cur_pt = shortest_paths[pt.x][pt.y];
-    if (cur_pt.is_reachable)
+    tWeight cur_dist = cur_pt.dist; // Distance to cur_pt
+    tWeight cur_weight = weights(cur_pt.x, cur_pt.y);
+    for (const auto &offset : NEIGHBOR_OFFSETS)
     {
-        if (pt.dist < cur_pt.dist)
+        tCoord x = cur_pt.x + offset.first;
+        tCoord y = cur_pt.y + offset.second;
+        if (x >= weights.rows() || y >= weights.cols() || shortest_path(x, y).is_visited) // negative offsets wrap around
         {
-            cur_pt.dist = pt.dist;
-            cur_pt.predecessor.x = pt.predecessor.x;
-            cur_pt.predecessor.y = pt.predecessor.y;
-            return false;
+            continue;
         }
+        tWeight dist = cur_dist + (reverse ? cur_weight : weights(x, y));
+        update_DijkstraPt(tPoint{x, y, dist, false, true, cur_pt}, shortest_path, reachable_pts, dist + heuristic(x, y));
     }
-    else
-    {
-        cur_pt = pt;
-        reachable_pts.push_back(&shortest_paths[pt.x][pt.y]);
-        return false;
-    }
-    return true;
 }
 
-
 /**
- * @brief sorts the queue of reachable points so shortest paths are at the end of the vector
+ * @brief Update or add point with coord [x,y] to the priority queue if the point has not been visited yet
  * 
- * @param reachable_pts vector of reachable points (pointer to points)
+ * @param pt can be seen as a path to reach coordinate [pt.x, pt.y]
+ * @param shortest_paths 2D-array of points
+ * @param reachable_pts queue of reachable points
+ * @param key priority of the point in the queue (distance plus heuristic)
  */
-void sort(tReachablePts &reachable_pts)
+template<typename Queue>
+void update_DijkstraPt(const tPoint &pt, tShortestPathGrid &shortest_paths, Queue &reachable_pts, const tWeight key)
 {
-    std::sort(reachable_pts.begin(), reachable_pts.end(), [](const tPoint *a, const tPoint *b) -> bool 
+    tPoint& cur_pt = shortest_paths(pt.x, pt.y);
+    if (cur_pt.is_reachable && !(pt.dist < cur_pt.dist))
     {
-        return (*b) < (*a);
-    });
+        return;
+    }
+    cur_pt = pt;
+    reachable_pts.push_or_decrease(shortest_paths.index(pt.x, pt.y), key);
 }
-
-
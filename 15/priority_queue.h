@@ -0,0 +1,231 @@
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * @brief Min-priority queue over node ids [0, num_nodes) implemented as 4-ary heap.
+ * The position of each node inside the heap is tracked, so keys can be decreased in place (no duplicate entries).
+ *
+ * @tparam K type of the key (distance)
+ */
+template<typename K>
+class QuaternaryHeap
+{
+public:
+    QuaternaryHeap(const size_t num_nodes, const K /*max_edge_weight*/) : m_heap{}, m_keys(num_nodes), m_pos(num_nodes, NOT_IN_HEAP) {};
+    bool empty() const;
+    size_t size() const;
+    void push_or_decrease(const size_t node, const K key);
+    size_t pop_min();
+
+private:
+    static constexpr size_t ARITY = 4u;
+    static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
+    void sift_up(size_t idx);
+    void sift_down(size_t idx);
+    void place(const size_t idx, const size_t node);
+
+    std::vector<size_t> m_heap; ///< node ids in heap order
+    std::vector<K> m_keys; ///< current key of each node
+    std::vector<size_t> m_pos; ///< index of each node in m_heap or NOT_IN_HEAP
+};
+
+template<typename K>
+bool QuaternaryHeap<K>::empty() const
+{
+    return m_heap.empty();
+}
+
+template<typename K>
+size_t QuaternaryHeap<K>::size() const
+{
+    return m_heap.size();
+}
+
+/**
+ * @brief Inserts node with the given key or lowers the key of the node if it is already part of the heap
+ *
+ * @param node id of the node
+ * @param key new key, ignored if it is not smaller than an already stored key
+ */
+template<typename K>
+void QuaternaryHeap<K>::push_or_decrease(const size_t node, const K key)
+{
+    if (m_pos[node] == NOT_IN_HEAP)
+    {
+        m_keys[node] = key;
+        m_heap.push_back(node);
+        m_pos[node] = m_heap.size() - 1;
+        sift_up(m_heap.size() - 1);
+    }
+    else if (key < m_keys[node])
+    {
+        m_keys[node] = key;
+        sift_up(m_pos[node]);
+    }
+}
+
+template<typename K>
+size_t QuaternaryHeap<K>::pop_min()
+{
+    if (m_heap.empty())
+    {
+        throw std::invalid_argument("Heap empty! No more entries found.");
+    }
+    size_t min_node = m_heap.front();
+    m_pos[min_node] = NOT_IN_HEAP;
+    size_t last_node = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty())
+    {
+        place(0, last_node);
+        sift_down(0);
+    }
+    return min_node;
+}
+
+template<typename K>
+void QuaternaryHeap<K>::place(const size_t idx, const size_t node)
+{
+    m_heap[idx] = node;
+    m_pos[node] = idx;
+}
+
+template<typename K>
+void QuaternaryHeap<K>::sift_up(size_t idx)
+{
+    size_t node = m_heap[idx];
+    while (idx > 0)
+    {
+        size_t parent = (idx - 1) / ARITY;
+        if (!(m_keys[node] < m_keys[m_heap[parent]]))
+        {
+            break;
+        }
+        place(idx, m_heap[parent]);
+        idx = parent;
+    }
+    place(idx, node);
+}
+
+template<typename K>
+void QuaternaryHeap<K>::sift_down(size_t idx)
+{
+    size_t node = m_heap[idx];
+    const size_t heap_size = m_heap.size();
+    while (true)
+    {
+        size_t first_child = idx * ARITY + 1;
+        if (first_child >= heap_size)
+        {
+            break;
+        }
+        size_t last_child = first_child + ARITY < heap_size ? first_child + ARITY : heap_size;
+        size_t min_child = first_child;
+        for (size_t child=first_child+1; child < last_child; ++child)
+        {
+            if (m_keys[m_heap[child]] < m_keys[m_heap[min_child]])
+            {
+                min_child = child;
+            }
+        }
+        if (!(m_keys[m_heap[min_child]] < m_keys[node]))
+        {
+            break;
+        }
+        place(idx, m_heap[min_child]);
+        idx = min_child;
+    }
+    place(idx, node);
+}
+
+
+/**
+ * @brief Monotone bucket queue (Dial's algorithm) for small integer edge weights in [1, max_edge_weight].
+ * All keys in the queue lie in [cur_key, cur_key + max_edge_weight], so max_edge_weight+1 circular buckets suffice.
+ * Decreasing a key appends a new entry, outdated entries are skipped lazily when popping.
+ *
+ * @tparam K unsigned integral type of the key (distance)
+ */
+template<typename K>
+class BucketQueue
+{
+public:
+    BucketQueue(const size_t num_nodes, const K max_edge_weight)
+        : m_buckets(static_cast<size_t>(max_edge_weight) + 1u), m_keys(num_nodes, NOT_IN_QUEUE), m_cur_key{0}, m_size{0} {};
+    bool empty() const;
+    size_t size() const;
+    void push_or_decrease(const size_t node, const K key);
+    size_t pop_min();
+
+private:
+    static constexpr K NOT_IN_QUEUE = std::numeric_limits<K>::max();
+
+    std::vector<std::vector<size_t>> m_buckets; ///< bucket i holds nodes with key % num_buckets == i (possibly outdated)
+    std::vector<K> m_keys; ///< current key of each node or NOT_IN_QUEUE
+    K m_cur_key; ///< smallest key that may still be in the queue
+    size_t m_size; ///< number of nodes with a valid entry
+};
+
+template<typename K>
+bool BucketQueue<K>::empty() const
+{
+    return m_size == 0u;
+}
+
+template<typename K>
+size_t BucketQueue<K>::size() const
+{
+    return m_size;
+}
+
+/**
+ * @brief Inserts node with the given key or lowers the key of the node if it is already part of the queue
+ *
+ * @param node id of the node
+ * @param key new key, all keys in the queue must lie within a range of max_edge_weight
+ */
+template<typename K>
+void BucketQueue<K>::push_or_decrease(const size_t node, const K key)
+{
+    if (m_size == 0u || key < m_cur_key)
+    {
+        m_cur_key = key; // the scan position must never lie behind a pushed key
+    }
+    if (m_keys[node] == NOT_IN_QUEUE)
+    {
+        ++m_size;
+    }
+    else if (!(key < m_keys[node]))
+    {
+        return;
+    }
+    m_keys[node] = key;
+    m_buckets[key % m_buckets.size()].push_back(node);
+}
+
+template<typename K>
+size_t BucketQueue<K>::pop_min()
+{
+    if (empty())
+    {
+        throw std::invalid_argument("Queue empty! No more entries found.");
+    }
+    while (true)
+    {
+        std::vector<size_t> &bucket = m_buckets[m_cur_key % m_buckets.size()];
+        while (!bucket.empty())
+        {
+            size_t node = bucket.back();
+            bucket.pop_back();
+            if (m_keys[node] == m_cur_key) // otherwise outdated entry of a decreased or already popped node
+            {
+                m_keys[node] = NOT_IN_QUEUE;
+                --m_size;
+                return node;
+            }
+        }
+        ++m_cur_key;
+    }
+}
@@ -1,4 +1,5 @@
 #include <string>
+#include <fstream>
 
 #include "bits_parser.h"
 
@@ -6,14 +7,26 @@ std::uint16_t acc_version_num(const std::string &file_path)
 {
     BitsParser bit_parser{};
 
-    std::unique_ptr<Packet> root_packet = bit_parser.parse_data(file_path);
-    return bit_parser.acc_versions(root_packet);
+    PacketTree packet_tree = bit_parser.parse_data(file_path);
+    return bit_parser.acc_versions(packet_tree);
 }
 
 std::uint64_t calc_packet_res(const std::string &file_path)
 {
     BitsParser bit_parser{};
 
-    std::unique_ptr<Packet> root_packet = bit_parser.parse_data(file_path);
-    return bit_parser.calc_rec(root_packet);
+    PacketTree packet_tree = bit_parser.parse_data(file_path);
+    return bit_parser.calc_rec(packet_tree);
+}
+
+std::uint64_t calc_packet_res_streaming(const std::string &file_path)
+{
+    BitsParser bit_parser{};
+
+    std::ifstream hex_stream{ file_path };
+    if (!hex_stream.is_open())
+    {
+        throw std::runtime_error("Could not open BITS transmission file!");
+    }
+    return bit_parser.evaluate_stream(hex_stream).value;
 }
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <istream>
+
+/**
+ * @brief Reads MSB-first bit fields from a hex transmission. The hex digits are packed into bytes once,
+ * fields are extracted with shift and mask from a 64 bit buffer that is refilled byte wise.
+ * A reader constructed from a stream packs the input chunk by chunk, so its memory does not depend on the input size.
+ */
+class BitReader
+{
+public:
+    explicit BitReader(const std::string &hex_in);
+    explicit BitReader(std::istream &hex_stream);
+    std::uint64_t read(const size_t num_bits);
+    bool read_bit();
+    size_t position() const;
+    size_t bits_left() const;
+
+private:
+    static constexpr size_t MAX_FIELD_BITS = 56u; ///< largest field that can be read at once
+    static constexpr size_t CHUNK_SIZE = 1u << 16; ///< number of hex chars read from a stream at once
+    static std::uint8_t hex_to_nibble(const char c);
+    void refill();
+    void load_chunk();
+
+    std::istream *m_stream{ nullptr }; ///< source of further hex chars, nullptr if the whole input is packed
+    std::vector<char> m_chars; ///< chars read from the stream
+    bool m_has_pending_nibble{ false }; ///< the last chunk ended with the high nibble of a byte
+    std::uint8_t m_pending_nibble{ 0 };
+    std::vector<std::uint8_t> m_bytes; ///< packed transmission (current chunk when reading from a stream)
+    size_t m_num_bits; ///< number of valid bits of the transmission (loaded so far when reading from a stream)
+    size_t m_next_byte; ///< index of the next byte to load into the buffer
+    std::uint64_t m_buffer; ///< buffered bits, the next bit to read is the MSB
+    size_t m_buffered_bits; ///< number of valid bits in m_buffer
+    size_t m_pos; ///< number of bits read so far
+};
+
+BitReader::BitReader(const std::string &hex_in)
+    : m_bytes((hex_in.size() + 1u) / 2u, 0u), m_num_bits{ 4u * hex_in.size() }, m_next_byte{ 0 }, m_buffer{ 0 }, m_buffered_bits{ 0 }, m_pos{ 0 }
+{
+    for (size_t i=0; i < hex_in.size(); ++i)
+    {
+        m_bytes[i/2] |= static_cast<std::uint8_t>(hex_to_nibble(hex_in[i]) << (i % 2u == 0u ? 4u : 0u));
+    }
+}
+
+BitReader::BitReader(std::istream &hex_stream)
+    : m_stream{ &hex_stream }, m_chars(CHUNK_SIZE), m_bytes{}, m_num_bits{ 0 }, m_next_byte{ 0 }, m_buffer{ 0 }, m_buffered_bits{ 0 }, m_pos{ 0 }
+{
+    m_bytes.reserve(CHUNK_SIZE / 2u + 1u);
+}
+
+/**
+ * @brief Reads the next num_bits bits as unsigned number (first bit is the most significant one)
+ *
+ * @param num_bits number of bits in [1, 56]
+ * @return std::uint64_t
+ */
+std::uint64_t BitReader::read(const size_t num_bits)
+{
+    if (num_bits == 0u || num_bits > MAX_FIELD_BITS)
+    {
+        throw std::invalid_argument("Bit field length out of range!");
+    }
+    if (num_bits > m_buffered_bits)
+    {
+        refill();
+        if (num_bits > m_buffered_bits)
+        {
+            throw std::runtime_error("Unexpected end of BITS transmission!");
+        }
+    }
+    std::uint64_t field = m_buffer >> (64u - num_bits);
+    m_buffer <<= num_bits;
+    m_buffered_bits -= num_bits;
+    m_pos += num_bits;
+    return field;
+}
+
+bool BitReader::read_bit()
+{
+    return read(1u) == 1u;
+}
+
+size_t BitReader::position() const
+{
+    return m_pos;
+}
+
+/**
+ * @brief Number of bits not yet read, for a stream only the bits of the chunks loaded so far are known
+ *
+ * @return size_t
+ */
+size_t BitReader::bits_left() const
+{
+    return m_num_bits - m_pos;
+}
+
+/**
+ * @brief Loads whole bytes into the buffer until it holds more than MAX_FIELD_BITS bits or the input ends
+ */
+void BitReader::refill()
+{
+    while (m_buffered_bits <= MAX_FIELD_BITS)
+    {
+        if (m_next_byte == m_bytes.size())
+        {
+            load_chunk();
+            if (m_bytes.empty())
+            {
+                break;
+            }
+        }
+        m_buffer |= static_cast<std::uint64_t>(m_bytes[m_next_byte++]) << (56u - m_buffered_bits);
+        m_buffered_bits += 8u;
+    }
+    // an odd number of hex digits leaves half a byte of padding that must not be read
+    const size_t bits_in_buffer_max = m_num_bits - m_pos;
+    if (m_buffered_bits > bits_in_buffer_max)
+    {
+        m_buffered_bits = bits_in_buffer_max;
+    }
+}
+
+/**
+ * @brief Packs the next chunk of the stream into m_bytes (leaves m_bytes empty at the end of the input).
+ * Whitespace is skipped, a trailing odd nibble is kept until the next chunk or padded at the end of the input.
+ */
+void BitReader::load_chunk()
+{
+    m_bytes.clear();
+    m_next_byte = 0;
+    while (m_stream != nullptr && m_bytes.empty())
+    {
+        m_stream->read(m_chars.data(), static_cast<std::streamsize>(m_chars.size()));
+        const size_t num_chars = static_cast<size_t>(m_stream->gcount());
+        for (size_t i=0; i < num_chars; ++i)
+        {
+            const char c = m_chars[i];
+            if (c == '\n' || c == '\r' || c == ' ' || c == '\t')
+            {
+                continue;
+            }
+            const std::uint8_t nibble = hex_to_nibble(c);
+            m_num_bits += 4u;
+            if (m_has_pending_nibble)
+            {
+                m_bytes.push_back(static_cast<std::uint8_t>((m_pending_nibble << 4) | nibble));
+                m_has_pending_nibble = false;
+            }
+            else
+            {
+                m_pending_nibble = nibble;
+                m_has_pending_nibble = true;
+            }
+        }
+        if (num_chars < m_chars.size()) // end of input
+        {
+            if (m_has_pending_nibble)
+            {
+                m_bytes.push_back(static_cast<std::uint8_t>(m_pending_nibble << 4));
+                m_has_pending_nibble = false;
+            }
+            m_stream = nullptr;
+        }
+    }
+}
+
+std::uint8_t BitReader::hex_to_nibble(const char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return static_cast<std::uint8_t>(c - '0');
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return static_cast<std::uint8_t>(c - 'A' + 10);
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return static_cast<std::uint8_t>(c - 'a' + 10);
+    }
+    throw std::runtime_error("Unexpected char in input BITS found!");
+}
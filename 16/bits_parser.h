@@ -1,8 +1,10 @@
 #include <string>
-#include <memory>
+#include <vector>
+#include <istream>
 #include <cassert>
 
 #include "../utility.h"
+#include "bit_reader.h"
 
 enum class LenTypeId : std::uint8_t
 {
@@ -24,269 +26,311 @@ enum class PackTypeId : std::uint8_t
 
 using cType = std::uint64_t;
 
+// packet stored in preorder, the sub packets of a packet directly follow it
 struct Packet
 {
     std::uint8_t version{};
     PackTypeId type_id{};
-    std::vector<std::unique_ptr<Packet>> sub_packets{};
-    Packet() = default;
-    Packet(std::uint8_t ver, PackTypeId type) : version{ver}, type_id{type} {};
+    std::uint32_t num_sub_packets{0u}; ///< number of direct sub packets (0 for literals)
+    std::uint32_t subtree_size{1u}; ///< number of packets in the subtree including this one, index + subtree_size is the next sibling
+    cType dec_number{}; ///< value of a literal packet
 };
 
-struct OperatorPackage : public Packet
+// result of the streaming evaluation of a transmission
+struct StreamResult
 {
-    std::uint32_t num_sub_packets{0u};
-    OperatorPackage() = default;
-    OperatorPackage(std::uint8_t ver, PackTypeId type, std::uint32_t num) : Packet(ver, type), num_sub_packets{num} {};
+    std::uint64_t version_sum{0u};
+    cType value{0u};
 };
 
-struct LiteralPackage : public Packet
+// all packets of a transmission in one contiguous vector, packets[0] is the outermost packet
+struct PacketTree
 {
-    cType dec_number{};
-    LiteralPackage() = default;
-    LiteralPackage(std::uint8_t ver, PackTypeId type, cType num) : Packet(ver, type), dec_number{num} {};
+    std::vector<Packet> packets{};
 };
 
 class BitsParser
 {
 public: 
 
-    std::unique_ptr<Packet> parse_data(const std::string &file_path) const;
-    std::uint32_t acc_versions(const std::unique_ptr<Packet> &packet) const;
-    cType calc_rec(const std::unique_ptr<Packet> &packet);
+    PacketTree parse_data(const std::string &file_path) const;
+    std::uint32_t acc_versions(const PacketTree &tree) const;
+    cType calc_rec(const PacketTree &tree) const;
+    StreamResult evaluate_stream(std::istream &hex_stream) const;
 
 private:
+    // operator whose sub packets are still being decoded by evaluate_stream
+    struct OperatorFrame
+    {
+        PackTypeId type_id{};
+        LenTypeId len_type_id{};
+        size_t len_decl{0u}; ///< end position in bits or number of sub packets, depending on len_type_id
+        std::uint32_t num_sub_packets{0u}; ///< number of sub packets folded so far
+        cType acc{0u}; ///< result of the sub packets folded so far
+    };
+    void fold_sub_packet(OperatorFrame &frame, const cType value) const;
+
     std::string read_hex_from_file(const std::string &file_path) const;
-    std::string convert_to_binary(const std::string hex_in) const;
-    std::unique_ptr<LiteralPackage> decode_literal_package(const std::string &pack, const size_t pos, size_t &new_pos) const;
-    std::unique_ptr<OperatorPackage> decode_operator_package(const std::string &pack, const size_t pos, size_t &new_pos) const;
-    std::unique_ptr<Packet> decode_packet(const std::string &packet, const size_t pos) const;
-    PackTypeId get_type(const std::string &pack, const size_t pos) const;
+    void decode_literal_package(BitReader &reader, Packet &packet) const;
+    void decode_operator_package(BitReader &reader, std::vector<Packet> &packets) const;
+    void decode_packet(BitReader &reader, std::vector<Packet> &packets) const;
 };
 
-cType BitsParser::calc_rec(const std::unique_ptr<Packet> &packet)
+/**
+ * @brief Evaluates the expression of the transmission. Packets are visited in reverse preorder,
+ * so the results of all sub packets are known when their operator is reached.
+ *
+ * @param tree
+ * @return cType result of the outermost packet
+ */
+cType BitsParser::calc_rec(const PacketTree &tree) const
 {
-    const OperatorPackage *op_ptr = nullptr;
-    if (packet->type_id != PackTypeId::LITERAL)
+    const std::vector<Packet> &packets = tree.packets;
+    if (packets.empty())
     {
-        op_ptr = static_cast<const OperatorPackage*>(packet.get());
-        if (op_ptr->num_sub_packets == 0)
-        {
-            return 0u;
-        }
+        throw std::invalid_argument("Packet tree is empty!");
     }
+    std::vector<cType> results(packets.size(), 0u);
 
-    switch(packet->type_id)
+    for (size_t idx=packets.size(); idx-- > 0; )
     {
-        case PackTypeId::SUM: 
+        const Packet &packet = packets[idx];
+        if (packet.type_id == PackTypeId::LITERAL)
         {
-            cType sum{0};
-            for (size_t i=0; i<op_ptr->num_sub_packets; ++i)
+            results[idx] = packet.dec_number;
+            continue;
+        }
+        if (packet.num_sub_packets == 0)
+        {
+            results[idx] = 0u;
+            continue;
+        }
+
+        // fold the sub packets, the first one directly follows the operator
+        size_t sub_idx = idx + 1;
+        cType res = results[sub_idx];
+        switch(packet.type_id)
+        {
+            case PackTypeId::SUM: 
+            case PackTypeId::PRODUCT: 
+            case PackTypeId::MIN: 
+            case PackTypeId::MAX: 
+                for (size_t i=1; i<packet.num_sub_packets; ++i)
+                {
+                    sub_idx += packets[sub_idx].subtree_size;
+                    const cType tmp = results[sub_idx];
+                    switch(packet.type_id)
+                    {
+                        case PackTypeId::SUM: 
+                            res += tmp;
+                            break;
+                        case PackTypeId::PRODUCT: 
+                            res *= tmp;
+                            break;
+                        case PackTypeId::MIN: 
+                            res = res > tmp ? tmp : res;
+                            break;
+                        default: 
+                            res = res < tmp ? tmp : res;
+                            break;
+                    }
+                }
+                break;
+            case PackTypeId::GT: 
+            case PackTypeId::LT: 
+            case PackTypeId::EQ: 
             {
-                sum += calc_rec(op_ptr->sub_packets[i]);
+                assert(packet.num_sub_packets == 2u);
+                const cType second = results[sub_idx + packets[sub_idx].subtree_size];
+                if (packet.type_id == PackTypeId::GT)
+                {
+                    res = res > second ? 1ull : 0ull;
+                }
+                else if (packet.type_id == PackTypeId::LT)
+                {
+                    res = res < second ? 1ull : 0ull;
+                }
+                else
+                {
+                    res = res == second ? 1ull : 0ull;
+                }
+                break;
             }
-            return sum;
-            break;
+            default:
+                throw std::runtime_error("Unknown operator type received!");
         }
-        case PackTypeId::PRODUCT: 
+        results[idx] = res;
+    }
+    return results[0];
+}
+
+/**
+ * @brief Decodes and evaluates the transmission in a single pass without building the packet tree.
+ * Open operators are kept on a stack and fold each sub packet result as soon as it is known,
+ * so memory only depends on the nesting depth and not on the size of the transmission.
+ *
+ * @param hex_stream stream of hex chars
+ * @return StreamResult sum of all version numbers and result of the outermost packet
+ */
+StreamResult BitsParser::evaluate_stream(std::istream &hex_stream) const
+{
+    BitReader reader{ hex_stream };
+    std::vector<OperatorFrame> stack;
+    StreamResult res{};
+
+    auto is_complete = [&reader](const OperatorFrame &frame){
+        return frame.len_type_id == LenTypeId::LEN_IN_BITS ? reader.position() >= frame.len_decl 
+                                                           : frame.num_sub_packets == frame.len_decl;
+    };
+
+    while (true)
+    {
+        res.version_sum += reader.read(3u);
+        PackTypeId type_id = static_cast<PackTypeId>(reader.read(3u));
+        cType value{0u};
+        if (type_id == PackTypeId::LITERAL)
         {
-            cType prod{1};
-            for (size_t i=0; i<op_ptr->num_sub_packets; ++i)
+            bool end_reached{false};
+            while (!end_reached)
             {
-                prod *= calc_rec(op_ptr->sub_packets[i]);
+                end_reached = !reader.read_bit();
+                value = (value << 4) | reader.read(4u);
             }
-            return prod;
-            break;
         }
-        case PackTypeId::MIN: 
+        else
         {
-            cType min_val{calc_rec(op_ptr->sub_packets.at(0))};
-            for (size_t i=1; i<op_ptr->num_sub_packets; ++i)
+            OperatorFrame frame{};
+            frame.type_id = type_id;
+            frame.len_type_id = reader.read_bit() ? LenTypeId::NUM_SUB_PACKETS : LenTypeId::LEN_IN_BITS;
+            frame.len_decl = static_cast<size_t>(reader.read(frame.len_type_id == LenTypeId::LEN_IN_BITS ? 15u : 11u));
+            if (frame.len_type_id == LenTypeId::LEN_IN_BITS)
             {
-                cType tmp = calc_rec(op_ptr->sub_packets.at(i));
-                min_val = min_val > tmp ? tmp : min_val;
+                frame.len_decl += reader.position();
             }
-            return min_val;
-            break;
+            if (!is_complete(frame))
+            {
+                stack.push_back(frame);
+                continue;
+            }
+            // operator without sub packets evaluates to 0
         }
-        case PackTypeId::MAX: 
+
+        // hand the value to the enclosing operators, closing every operator that is complete
+        while (true)
         {
-            cType max_val{calc_rec(op_ptr->sub_packets.at(0))};
-            for (size_t i=1; i<op_ptr->num_sub_packets; ++i)
+            if (stack.empty())
             {
-                cType tmp = calc_rec(op_ptr->sub_packets.at(i));
-                max_val = max_val < tmp ? tmp : max_val;
+                res.value = value;
+                return res;
             }
-            return max_val;
-            break;
+            OperatorFrame &parent = stack.back();
+            fold_sub_packet(parent, value);
+            if (!is_complete(parent))
+            {
+                break;
+            }
+            value = parent.acc;
+            stack.pop_back();
         }
-        case PackTypeId::LITERAL: 
-            return static_cast<const LiteralPackage*>(packet.get())->dec_number;
+    }
+}
+
+void BitsParser::fold_sub_packet(OperatorFrame &frame, const cType value) const
+{
+    if (frame.num_sub_packets++ == 0u)
+    {
+        frame.acc = value;
+        return;
+    }
+    switch(frame.type_id)
+    {
+        case PackTypeId::SUM: 
+            frame.acc += value;
+            break;
+        case PackTypeId::PRODUCT: 
+            frame.acc *= value;
+            break;
+        case PackTypeId::MIN: 
+            frame.acc = frame.acc > value ? value : frame.acc;
+            break;
+        case PackTypeId::MAX: 
+            frame.acc = frame.acc < value ? value : frame.acc;
             break;
         case PackTypeId::GT: 
-            assert(op_ptr->num_sub_packets == 2u);
-            if (calc_rec(op_ptr->sub_packets[0]) > calc_rec(op_ptr->sub_packets[1]))
-            {
-                return 1ull;
-            }
+            assert(frame.num_sub_packets == 2u);
+            frame.acc = frame.acc > value ? 1ull : 0ull;
             break;
         case PackTypeId::LT: 
-            assert(op_ptr->num_sub_packets == 2u);
-            if (calc_rec(op_ptr->sub_packets[0]) < calc_rec(op_ptr->sub_packets[1]))
-            {
-                return 1ull;
-            }
+            assert(frame.num_sub_packets == 2u);
+            frame.acc = frame.acc < value ? 1ull : 0ull;
             break;
         case PackTypeId::EQ: 
-            assert(op_ptr->num_sub_packets == 2u);
-            if (calc_rec(op_ptr->sub_packets[0]) == calc_rec(op_ptr->sub_packets[1]))
-            {
-                return 1ull;
-            }
+            assert(frame.num_sub_packets == 2u);
+            frame.acc = frame.acc == value ? 1ull : 0ull;
             break;
         default:
             throw std::runtime_error("Unknown operator type received!");
     }
-    return 0ull;
 }
 
-std::unique_ptr<Packet> BitsParser::decode_packet(const std::string &packet, const size_t pos) const
+/**
+ * @brief Appends the next packet and all its sub packets in preorder to packets
+ *
+ * @param reader
+ * @param packets
+ */
+void BitsParser::decode_packet(BitReader &reader, std::vector<Packet> &packets) const
 {
-    assert(packet.length() > 5u);
-    PackTypeId type_id = get_type(packet, pos);
-    size_t new_pos{0};
-    if (type_id == PackTypeId::LITERAL)
+    Packet packet{};
+    packet.version = static_cast<std::uint8_t>(reader.read(3u));
+    packet.type_id = static_cast<PackTypeId>(reader.read(3u));
+    if (packet.type_id == PackTypeId::LITERAL)
     {
-        return decode_literal_package(packet, pos, new_pos);
+        decode_literal_package(reader, packet);
+        packets.push_back(packet);
     }
     else
     {
-        return decode_operator_package(packet, pos, new_pos);
+        packets.push_back(packet);
+        decode_operator_package(reader, packets);
     }
 }
 
-std::unique_ptr<OperatorPackage> BitsParser::decode_operator_package(const std::string &packet, const size_t pos, size_t &new_pos) const
+void BitsParser::decode_operator_package(BitReader &reader, std::vector<Packet> &packets) const
 {
-    assert(packet.length() > 5u);
-    std::unique_ptr<OperatorPackage> op_packet = std::make_unique<OperatorPackage>();
-    op_packet->version = static_cast<std::uint8_t>(bin_str_to_uint(packet.substr(pos,3)));
-    op_packet->type_id = get_type(packet, pos);
-    size_t cur_pos{pos+6};
+    // packets may reallocate while decoding sub packets, so the operator is referenced by index
+    const size_t op_idx = packets.size() - 1;
 
     // distinguish between length specification in bits or number of packets
-    LenTypeId len_type_id = packet.at(cur_pos++) == '0' ? LenTypeId::LEN_IN_BITS : LenTypeId::NUM_SUB_PACKETS;
+    LenTypeId len_type_id = reader.read_bit() ? LenTypeId::NUM_SUB_PACKETS : LenTypeId::LEN_IN_BITS;
     size_t relevant_bits = len_type_id == LenTypeId::LEN_IN_BITS ? 15u : 11u;
 
     // unpack packet
-    std::uint32_t len_decl = static_cast<std::uint32_t>(bin_str_to_uint(packet.substr(cur_pos, relevant_bits)));
-    cur_pos += relevant_bits;
-    size_t end_pos = cur_pos + len_decl;
+    std::uint32_t len_decl = static_cast<std::uint32_t>(reader.read(relevant_bits));
+    size_t end_pos = reader.position() + len_decl;
     std::uint32_t num_sub_packets{0};
-    while ((LenTypeId::LEN_IN_BITS == len_type_id && cur_pos < end_pos)
+    while ((LenTypeId::LEN_IN_BITS == len_type_id && reader.position() < end_pos)
             || (LenTypeId::NUM_SUB_PACKETS == len_type_id && num_sub_packets < len_decl))
     {
         ++num_sub_packets;
-        size_t tmp_pos{};
-        if (PackTypeId::LITERAL == get_type(packet, cur_pos))
-        { // Literal sub-packet
-            op_packet->sub_packets.push_back(decode_literal_package(packet, cur_pos, tmp_pos));
-        }
-        else // Operator sub-packet
-        {
-            op_packet->sub_packets.push_back(decode_operator_package(packet, cur_pos, tmp_pos));
-        }
-        cur_pos = tmp_pos;
+        decode_packet(reader, packets);
     }
-    op_packet->num_sub_packets = num_sub_packets;
-    new_pos = cur_pos;
-    return op_packet;
+    packets[op_idx].num_sub_packets = num_sub_packets;
+    packets[op_idx].subtree_size = static_cast<std::uint32_t>(packets.size() - op_idx);
 }
 
-std::unique_ptr<LiteralPackage> BitsParser::decode_literal_package(const std::string &pack, const size_t pos, size_t &new_pos) const
+void BitsParser::decode_literal_package(BitReader &reader, Packet &packet) const
 {
-    assert(pack.length() > 5u);
-    std::uint8_t version = static_cast<std::uint8_t>(bin_str_to_uint(pack.substr(pos,3)));
-    PackTypeId type_id = get_type(pack, pos);
-    size_t cur_pos{pos+6};
-    std::string bin_str;
+    cType dec_number{0};
     bool end_reached{false};
     while (!end_reached)
     {
-        bin_str += pack.substr(cur_pos+1,4);
-        end_reached = pack.at(cur_pos) == '0';
-        cur_pos += 5;
-    }
-    // size_t num_pads = (4 - (cur_pos - pos) % 4) % 4; 
-    // new_pos = cur_pos + num_pads;
-    new_pos = cur_pos;
-    cType dec_number = bin_str_to_uint(bin_str);
-
-    return std::make_unique<LiteralPackage>(version, type_id, dec_number);
-}
-
-std::string BitsParser::convert_to_binary(const std::string hex_in) const
-{
-    std::string binary;
-    for (const auto c : hex_in)
-    {
-        switch(c) 
-        {
-            case '0': 
-                binary += "0000";
-                break;
-            case '1': 
-                binary += "0001";
-                break;
-            case '2': 
-                binary += "0010";
-                break;
-            case '3': 
-                binary += "0011";
-                break;
-            case '4': 
-                binary += "0100";
-                break;
-            case '5': 
-                binary += "0101";
-                break;
-            case '6': 
-                binary += "0110";
-                break;
-            case '7': 
-                binary += "0111";
-                break;
-            case '8': 
-                binary += "1000";
-                break;
-            case '9': 
-                binary += "1001";
-                break;
-            case 'A': 
-                binary += "1010";
-                break;
-            case 'B': 
-                binary += "1011";
-                break;
-            case 'C': 
-                binary += "1100";
-                break;
-            case 'D': 
-                binary += "1101";
-                break;
-            case 'E': 
-                binary += "1110";
-                break;
-            case 'F': 
-                binary += "1111";
-                break;
-            default: 
-                throw std::runtime_error("Unexpected char in input BITS found!");
-        }
+        end_reached = !reader.read_bit();
+        dec_number = (dec_number << 4) | reader.read(4u);
     }
-    return binary;
+    packet.dec_number = dec_number;
 }
 
-
 std::string BitsParser::read_hex_from_file(const std::string& file_path) const
 {
     std::fstream input_file;
@@ -300,28 +344,22 @@ std::string BitsParser::read_hex_from_file(const std::string& file_path) const
 }
 
 
-std::unique_ptr<Packet> BitsParser::parse_data(const std::string &file_path) const
+PacketTree BitsParser::parse_data(const std::string &file_path) const
 {
     std::string hex_data = read_hex_from_file(file_path);
-    std::string bin_data = convert_to_binary(hex_data);
-    return decode_packet(bin_data, 0u);
+    BitReader reader{ hex_data };
+    PacketTree tree{};
+    decode_packet(reader, tree.packets);
+    return tree;
 }
 
 
-PackTypeId BitsParser::get_type(const std::string &pack, const size_t pos) const
-{
-    assert(pack.length() > 5u);
-    return static_cast<PackTypeId>(bin_str_to_uint(pack.substr(pos+3,3)));
-}
-
-std::uint32_t BitsParser::acc_versions(const std::unique_ptr<Packet> &packet) const
+std::uint32_t BitsParser::acc_versions(const PacketTree &tree) const
 {
     std::uint32_t versions{0};
-    versions += static_cast<std::uint32_t>(packet->version);
-
-    for (size_t i=0; i < packet->sub_packets.size(); ++i)
+    for (const auto &packet : tree.packets)
     {
-        versions += acc_versions(packet->sub_packets[i]);
+        versions += static_cast<std::uint32_t>(packet.version);
     }
     return versions;
 }
@@ -4,15 +4,30 @@
 #include <set>
 #include <iomanip>
 #include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include <numeric>
+#include <functional>
+#include <queue>
+#include <limits>
 
 #include "../utility.h"
+#include "flat_point_set.h"
 
 namespace {
 constexpr float SIMILARITY_THRES = 1.0f;
+constexpr size_t MIN_COMMON_BEACONS = 12u; // reports sharing at least this many beacons can be aligned
+constexpr size_t MIN_SHARED_DISTANCES = MIN_COMMON_BEACONS * (MIN_COMMON_BEACONS - 1u) / 2u; // distances between the common beacons
 const std::string TARGET_SYSTEM{ "scanner 0" };
 
 using tCoord = int;
 
+enum class AlignmentMode
+{
+    ALL_PAIRS, ///< aligns all report pairs up front and chains the transformations afterwards
+    INCREMENTAL, ///< places the reports one after another in breadth first order starting at TARGET_SYSTEM
+};
+
 struct Trafo
 {
     int xx;
@@ -56,20 +71,85 @@ Trafo operator*(const Trafo &t1, const Trafo &t2)
     return res;
 }
 
+// entry of the fingerprint index: two beacons of one scanner report
+struct BeaconPair
+{
+    std::uint32_t report; ///< index of the report
+    std::uint32_t beacon_1; ///< index of the first beacon in the report
+    std::uint32_t beacon_2; ///< index of the second beacon in the report
+};
+using tOverlapPts = std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>>;
+
+// all fingerprint collisions between two reports (rep_1 < rep_2)
+struct ReportPairCollisions
+{
+    size_t rep_1;
+    size_t rep_2;
+    std::vector<std::pair<BeaconPair, BeaconPair>> collisions; ///< beacon pairs of rep_1 and rep_2 with equal distance
+};
+
+/**
+ * @brief Fingerprint index: flat inverted index of the squared distances (independent of rotation and translation) 
+ * of all beacon pairs of all reports. The pairs are stored report by report, pairs with equal distance are linked 
+ * to a chain whose head is found in an open addressing table, so no allocation per distance is needed.
+ */
+class DistanceIndex
+{
+public:
+    explicit DistanceIndex(const std::vector<const std::vector<Point3D<tCoord>>*> &reports);
+    size_t num_reports() const;
+    template<typename Func>
+    void for_each_collision(const size_t rep, Func func) const;
+
+private:
+    static constexpr std::uint32_t NO_ENTRY = std::numeric_limits<std::uint32_t>::max();
+
+    size_t slot_of(const std::int32_t dist) const;
+
+    std::vector<BeaconPair> m_pairs; ///< beacon pairs of all reports, ordered by report
+    std::vector<std::int32_t> m_dists; ///< squared distance of each pair
+    std::vector<std::uint32_t> m_next; ///< next pair with the same distance or NO_ENTRY
+    std::vector<size_t> m_offsets; ///< first pair of each report, num_reports+1 entries
+    std::vector<std::int32_t> m_slot_dists; ///< distance of each slot, -1 for a free slot
+    std::vector<std::uint32_t> m_slot_heads; ///< first pair of the chain of each slot
+};
+
+// points stored as structure of arrays, so transformations run as vectorizable loops over each coordinate
+struct PointsSoA
+{
+    std::vector<tCoord> x;
+    std::vector<tCoord> y;
+    std::vector<tCoord> z;
+};
+
+// alignment result of one report pair
+struct PairAlignment
+{
+    bool is_aligned{ false }; ///< true if the reports share enough beacons
+    Trafo trafo_2_to_1{}; ///< transforms points of rep_2 into the system of rep_1
+};
+
 std::map<std::string, std::vector<Point3D<tCoord>>> read_scanner_report(const std::string &file_path);
+std::vector<ReportPairCollisions> get_candidate_pairs(const DistanceIndex &index);
+tOverlapPts get_overlapping_beacons_indexed(const ReportPairCollisions &pair_collisions, const std::vector<const std::vector<Point3D<tCoord>>*> &reports);
+Trafo inverse(const Trafo &trafo);
+PairAlignment align_overlap(const tOverlapPts &similar_pt_ids);
+std::uint16_t get_number_of_beacons_incremental(const std::vector<std::string> &report_names, const std::vector<const std::vector<Point3D<tCoord>>*> &reports);
 template<typename T>
 std::map<Point3D<tCoord>,std::vector<T>> calc_connection_ids(const std::vector<Point3D<tCoord>> &beacon_vec);
 template<typename T>
 std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> get_overlapping_beacons(const std::map<Point3D<tCoord>, std::vector<T>> &point_map_1, const std::map<Point3D<tCoord>, std::vector<T>>&point_map_2);
-std::vector<Point3D<tCoord>> transform_points(const Trafo m, const std::vector<Point3D<tCoord>> &point_map);
+PointsSoA to_soa(const std::vector<Point3D<tCoord>> &point_vec);
+void transform_points(const Trafo &m, const PointsSoA &points, PointsSoA &transformed);
+void insert_points(const PointsSoA &points, FlatPointSet<tCoord> &point_set);
 Point3D<tCoord> transform_point(const Trafo m, const Point3D<tCoord> &point);
 Trafo get_trafo(const std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> &overlap_pts);
 bool is_unique_abs_elem(const tCoord val, const Point3D<tCoord> pt);
 int get_trafo_elem(const tCoord c1, const tCoord c2);
 std::map<std::string, std::vector<std::string>> get_transformation_chain(const std::map<std::string, std::vector<std::string>> &r_t_assignment, const std::string target_system);
-std::map<std::string, std::vector<Point3D<tCoord>>> transform_pts(const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map, const std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment, const std::string target_system);
-std::set<Point3D<tCoord>> get_unique_pts(const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map);
-std::uint32_t get_largest_dist(const std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment);
+std::map<std::string, Trafo> get_absolute_trafos(const std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment);
+FlatPointSet<tCoord> get_unique_pts(const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map, const std::map<std::string, Trafo> &abs_trafos);
+std::uint32_t get_largest_dist(const std::vector<Trafo> &abs_trafos);
 std::uint32_t manhatten_dist(const Point3D<tCoord> &p1, const Point3D<tCoord> &p2);
 
 
@@ -130,95 +210,248 @@ void print_trafo(Trafo trafo, const std::string &name1, const std::string &name2
     std::cout << std::setw(2) << trafo.zx << " " << std::setw(2) << trafo.zy << " " << std::setw(2) << trafo.zz << std::setw(6) << trafo.tz << "\n"; 
 }
 
-std::uint16_t get_number_of_beacons(const std::string &file_path)
+std::uint16_t get_number_of_beacons(const std::string &file_path, const size_t num_threads = 1u, const AlignmentMode mode = AlignmentMode::ALL_PAIRS)
 {
     std::map<std::string, std::vector<Point3D<tCoord>>> scan_map = read_scanner_report(file_path);
-    std::map<std::string, std::map<Point3D<tCoord>, std::vector<std::int32_t>>> scanner_point_map{};
-    std::ofstream my_file("IDs.txt");
-    // iterate through each scanner report and calc for each beacon a vector of connection weights
+    std::vector<std::string> report_names;
+    std::vector<const std::vector<Point3D<tCoord>>*> reports;
     for (const auto &mat : scan_map)
     {
-        scanner_point_map[mat.first] = calc_connection_ids<std::int32_t>(mat.second);
-        // print_id_map<std::int32_t>(my_file, scanner_point_map[mat.first], mat.first);
-        my_file << "\n";
-    }  
+        report_names.push_back(mat.first);
+        reports.push_back(&mat.second);
+    }
 
+    if (mode == AlignmentMode::INCREMENTAL)
+    {
+        return get_number_of_beacons_incremental(report_names, reports);
+    }
+
+    // find candidate report pairs via collisions in the distance index
+    const DistanceIndex index{ reports };
+    std::vector<ReportPairCollisions> candidates = get_candidate_pairs(index);
+
+    // align each unordered pair once, every thread writes only the slots of its own pairs
+    std::vector<PairAlignment> alignments(candidates.size());
+    std::vector<size_t> pair_ids(candidates.size());
+    std::iota(pair_ids.begin(), pair_ids.end(), 0u);
+    std::function<void(size_t&, const size_t)> align_pair = [&](size_t &pair_id, const size_t /*thread_idx*/)
+    {
+        alignments[pair_id] = align_overlap(get_overlapping_beacons_indexed(candidates[pair_id], reports));
+    };
+    run_work_stealing(std::move(pair_ids), num_threads, align_pair);
+
+    // the trafo of the opposite direction is the inverse
     std::map<std::string, std::vector<std::string>> report_report_assignment; // stores for each report all reports that share at least 12 points -> trafo exists
     std::map<std::string, std::map<std::string,Trafo>> report_trafo_assignment;
-    // compare each point of a scanner report to each point of the remaining reports
-    for (const auto &mat : scan_map)
+    for (const auto &name : report_names)
+    {
+        report_report_assignment[name] = {};
+        report_trafo_assignment[name] = {};
+    }
+    for (size_t pair_id=0; pair_id < candidates.size(); ++pair_id)
     {
-        std::vector<std::string> trafo_vec;
-        std::map<std::string, Trafo> trafo_map;
-        for (const auto &mat_2 : scan_map)
+        if (!alignments[pair_id].is_aligned)
         {
-            if (mat.first == mat_2.first) 
-            {
-                continue;
-            }
-            else
-            {
-
-                std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> similar_pt_ids = get_overlapping_beacons<std::int32_t>(scanner_point_map[mat.first],scanner_point_map[mat_2.first]);
-                // print_similar_points(similar_pt_ids, mat.first, mat_2.first);
-                if (similar_pt_ids.size() >= 11)
-                {
-                    Trafo trafo = get_trafo(similar_pt_ids);
-                    trafo_map[mat_2.first] = trafo;
-                    trafo_vec.push_back(mat_2.first);
-                    // print_trafo(trafo, mat.first, mat_2.first);
-                    std::vector<Point3D<tCoord>> trafo_pt_vec;
-                }
-            }
+            continue;
         }
-        report_report_assignment[mat.first] = trafo_vec;
-        report_trafo_assignment[mat.first] = trafo_map;
+        const std::string &name_1 = report_names[candidates[pair_id].rep_1];
+        const std::string &name_2 = report_names[candidates[pair_id].rep_2];
+        report_trafo_assignment[name_1][name_2] = alignments[pair_id].trafo_2_to_1;
+        report_trafo_assignment[name_2][name_1] = inverse(alignments[pair_id].trafo_2_to_1);
+        report_report_assignment[name_1].push_back(name_2);
+        report_report_assignment[name_2].push_back(name_1);
     }
 
     std::map<std::string, std::vector<std::string>> trafo_map; // Stores for each scanner report a vector of transformations to be executed to transform points to system of report 0
     trafo_map = get_transformation_chain(report_report_assignment, TARGET_SYSTEM);
 
-    std::map<std::string, std::vector<Point3D<tCoord>>> scan_map_transformed = transform_pts(scan_map, trafo_map, report_trafo_assignment, TARGET_SYSTEM);
-    // std::cout << std::endl;
-    // print_scanner_map(scan_map_transformed);
-    std::set<Point3D<tCoord>> unique_pts = get_unique_pts(scan_map_transformed);
-    std::cout << "Largest Manhatten Dist: " << get_largest_dist(trafo_map, report_trafo_assignment) << std::endl;
+    // compose each chain once, so every point is transformed a single time
+    std::map<std::string, Trafo> abs_trafos = get_absolute_trafos(trafo_map, report_trafo_assignment);
+    std::vector<Trafo> abs_trafo_vec;
+    for (const auto &abs_trafo : abs_trafos)
+    {
+        abs_trafo_vec.push_back(abs_trafo.second);
+    }
+
+    FlatPointSet<tCoord> unique_pts = get_unique_pts(scan_map, abs_trafos);
+    std::cout << "Largest Manhatten Dist: " << get_largest_dist(abs_trafo_vec) << std::endl;
     std::cout << "Number of beacons: " << unique_pts.size() << std::endl;
-    return unique_pts.size();
+    return static_cast<std::uint16_t>(unique_pts.size());
 }
 
-std::uint32_t get_largest_dist(const std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment)
+/**
+ * @brief Places the reports in breadth first order starting at TARGET_SYSTEM. Each placed report is aligned
+ * against the reports not placed yet, matching reports get their absolute transformation by composing it 
+ * with the one of the placed report, and their beacons are merged into the point cloud.
+ * The candidates of a placed report are found by looking up only its own distances in the distance index, 
+ * so no global list of candidate pairs is built and pairs of two placed reports are never compared.
+ * If no placed report is left to compare with, the unplaced reports are matched against the merged point cloud, 
+ * which also finds reports sharing enough beacons only with the union of several placed reports.
+ * 
+ * @param report_names 
+ * @param reports beacons of each report
+ * @return std::uint16_t number of unique beacons
+ */
+std::uint16_t get_number_of_beacons_incremental(const std::vector<std::string> &report_names, const std::vector<const std::vector<Point3D<tCoord>>*> &reports)
 {
-    std::vector<std::pair<std::string,Point3D<tCoord>>> translation_vec;
-    for (const auto &rep_trafo_vec : trafo_map)
+    auto target = std::find(report_names.begin(), report_names.end(), TARGET_SYSTEM);
+    if (target == report_names.end())
     {
-        if (rep_trafo_vec.second.size() == 1) // vector for target system has size of 1
+        throw std::runtime_error("Target system not part of the scanner reports!");
+    }
+    const DistanceIndex index{ reports };
+    std::vector<ReportPairCollisions> pair_collisions(reports.size()); ///< collisions of the current placed report with each unplaced report
+
+    const Trafo identity{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+    std::vector<Trafo> abs_trafos(reports.size()); ///< transforms points of a report into the target system
+    std::vector<bool> is_placed(reports.size(), false);
+    FlatPointSet<tCoord> point_cloud;
+    std::vector<Point3D<tCoord>> cloud_pts; ///< points of point_cloud in order of insertion
+    PointsSoA transformed;
+    std::queue<size_t> placed_queue;
+    size_t num_placed{ 0 };
+
+    auto place = [&](const size_t rep, const Trafo &abs_trafo){
+        abs_trafos[rep] = abs_trafo;
+        is_placed[rep] = true;
+        transform_points(abs_trafo, to_soa(*reports[rep]), transformed);
+        for (size_t i=0; i<transformed.x.size(); ++i)
+        {
+            const Point3D<tCoord> pt{ transformed.x[i], transformed.y[i], transformed.z[i] };
+            if (point_cloud.insert(pt))
+            {
+                cloud_pts.push_back(pt);
+            }
+        }
+        placed_queue.push(rep);
+        ++num_placed;
+    };
+
+    // matches all unplaced reports against the merged cloud (report 0 of cloud_reports), whose points are already in the target system
+    auto place_against_cloud = [&](){
+        std::vector<const std::vector<Point3D<tCoord>>*> cloud_reports{ &cloud_pts };
+        std::vector<size_t> unplaced;
+        for (size_t rep=0; rep < reports.size(); ++rep)
         {
+            if (!is_placed[rep])
+            {
+                unplaced.push_back(rep);
+                cloud_reports.push_back(reports[rep]);
+            }
+        }
+        const DistanceIndex cloud_index{ cloud_reports };
+        std::vector<ReportPairCollisions> cloud_collisions;
+        for (size_t i=0; i < cloud_reports.size(); ++i)
+        {
+            cloud_collisions.push_back({ 0u, i, {} });
+        }
+        cloud_index.for_each_collision(0u, [&cloud_collisions](const BeaconPair &cloud_pair, const BeaconPair &other_pair){
+            cloud_collisions[other_pair.report].collisions.emplace_back(cloud_pair, other_pair);
+        });
+
+        bool has_placed{ false };
+        for (size_t i=1; i < cloud_reports.size(); ++i)
+        {
+            if (cloud_collisions[i].collisions.size() < MIN_SHARED_DISTANCES)
+            {
+                continue;
+            }
+            // beacons appended to cloud_pts by place do not change the indices of the collisions
+            const PairAlignment alignment = align_overlap(get_overlapping_beacons_indexed(cloud_collisions[i], cloud_reports));
+            if (alignment.is_aligned)
+            {
+                place(unplaced[i-1], alignment.trafo_2_to_1);
+                has_placed = true;
+            }
+        }
+        return has_placed;
+    };
+
+    place(static_cast<size_t>(target - report_names.begin()), identity);
+    while (num_placed < reports.size())
+    {
+        if (placed_queue.empty())
+        {
+            if (!place_against_cloud())
+            {
+                break;
+            }
             continue;
         }
-        std::string start_system = rep_trafo_vec.first;
+        const size_t placed = placed_queue.front();
+        placed_queue.pop();
+        for (size_t rep=0; rep < reports.size(); ++rep)
+        {
+            pair_collisions[rep] = { std::min(placed, rep), std::max(placed, rep), {} };
+        }
+        index.for_each_collision(placed, [&](const BeaconPair &placed_pair, const BeaconPair &other_pair){
+            if (!is_placed[other_pair.report])
+            {
+                auto &collisions = pair_collisions[other_pair.report].collisions;
+                placed < other_pair.report ? collisions.emplace_back(placed_pair, other_pair) : collisions.emplace_back(other_pair, placed_pair);
+            }
+        });
+
+        for (size_t rep=0; rep < reports.size() && num_placed < reports.size(); ++rep)
+        {
+            if (is_placed[rep] || pair_collisions[rep].collisions.size() < MIN_SHARED_DISTANCES)
+            {
+                continue;
+            }
+            const PairAlignment alignment = align_overlap(get_overlapping_beacons_indexed(pair_collisions[rep], reports));
+            if (!alignment.is_aligned)
+            {
+                continue;
+            }
+            const Trafo trafo_to_placed = placed < rep ? alignment.trafo_2_to_1 : inverse(alignment.trafo_2_to_1);
+            place(rep, abs_trafos[placed] * trafo_to_placed);
+        }
+    }
+    if (num_placed < reports.size())
+    {
+        throw std::runtime_error("Not all scanner reports could be placed!");
+    }
+
+    std::cout << "Largest Manhatten Dist: " << get_largest_dist(abs_trafos) << std::endl;
+    std::cout << "Number of beacons: " << point_cloud.size() << std::endl;
+    return static_cast<std::uint16_t>(point_cloud.size());
+}
+
+/**
+ * @brief Composes the chain of transformations of each report into one transformation to the target system
+ * 
+ * @param trafo_map chain of reports for each report, starting at the target system
+ * @param report_trafo_assignment transformation matrices between directly overlapping reports
+ * @return std::map<std::string, Trafo> 
+ */
+std::map<std::string, Trafo> get_absolute_trafos(const std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment)
+{
+    const Trafo identity{ 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+    std::map<std::string, Trafo> abs_trafos;
+    for (const auto &rep_trafo_vec : trafo_map)
+    {
         const std::vector<std::string> &trafos = rep_trafo_vec.second;
-        Trafo overall_trafo = report_trafo_assignment.at(trafos.at(0)).at(trafos.at(1));
-        for (size_t i=1; i<trafos.size()-1; ++i)
+        Trafo overall_trafo = identity;
+        for (size_t i=0; i+1<trafos.size(); ++i)
         {
              overall_trafo = overall_trafo * report_trafo_assignment.at(trafos.at(i)).at(trafos.at(i+1));
         }
-        // std::cout << overall_trafo << "\n" <<std::endl;
-        translation_vec.push_back(std::make_pair(start_system, Point3D<tCoord>{overall_trafo.tx, overall_trafo.ty, overall_trafo.tz}));
+        abs_trafos[rep_trafo_vec.first] = overall_trafo;
     }
+    return abs_trafos;
+}
 
-    translation_vec.push_back(std::make_pair(TARGET_SYSTEM, Point3D<tCoord>{0,0,0}));
-
+std::uint32_t get_largest_dist(const std::vector<Trafo> &abs_trafos)
+{
     std::uint32_t largest_dist{0};
-    for (size_t i=0; i<translation_vec.size(); ++i)
+    for (size_t i=0; i<abs_trafos.size(); ++i)
     {
-        for (size_t j=i+1; j<translation_vec.size(); ++j)
+        for (size_t j=i+1; j<abs_trafos.size(); ++j)
         {
-            std::uint32_t dist = manhatten_dist(translation_vec[i].second, translation_vec[j].second);
+            std::uint32_t dist = manhatten_dist({abs_trafos[i].tx, abs_trafos[i].ty, abs_trafos[i].tz}, {abs_trafos[j].tx, abs_trafos[j].ty, abs_trafos[j].tz});
             if (dist > largest_dist)
             {
                 largest_dist = dist;
-                std::uint32_t dist2 = manhatten_dist(translation_vec[i].second, translation_vec[j].second);
             }
         }
     }
@@ -231,29 +464,87 @@ std::uint32_t manhatten_dist(const Point3D<tCoord> &p1, const Point3D<tCoord> &p
     return static_cast<std::uint32_t>(tmp);
 }
 
-std::set<Point3D<tCoord>> get_unique_pts(const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map)
+/**
+ * @brief Transforms the beacons of all reports with a known absolute transformation into the target system 
+ * and removes duplicates
+ * 
+ * @param scan_map beacons of each report
+ * @param abs_trafos transformation of each report to the target system
+ * @return FlatPointSet<tCoord> 
+ */
+FlatPointSet<tCoord> get_unique_pts(const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map, const std::map<std::string, Trafo> &abs_trafos)
 {
-    std::set<Point3D<tCoord>> pt_set;
+    size_t num_pts{0};
     for (const auto &report : scan_map)
     {
-        for (const auto &pt : report.second)
-        {
-            pt_set.insert(pt);
-        }
+        num_pts += report.second.size();
+    }
+    FlatPointSet<tCoord> pt_set{ num_pts };
+    PointsSoA transformed;
+    for (const auto &abs_trafo : abs_trafos)
+    {
+        transform_points(abs_trafo.second, to_soa(scan_map.at(abs_trafo.first)), transformed);
+        insert_points(transformed, pt_set);
     }
     return pt_set;
 }
 
-std::vector<Point3D<tCoord>> transform_points(const Trafo m, const std::vector<Point3D<tCoord>> &point_vec)
+PointsSoA to_soa(const std::vector<Point3D<tCoord>> &point_vec)
 {
-    std::vector<Point3D<tCoord>> trafo_pt_vec;
+    PointsSoA points;
+    points.x.reserve(point_vec.size());
+    points.y.reserve(point_vec.size());
+    points.z.reserve(point_vec.size());
     for (const auto &pt : point_vec)
     {
-        trafo_pt_vec.push_back(transform_point(m, pt));
+        points.x.push_back(pt.x);
+        points.y.push_back(pt.y);
+        points.z.push_back(pt.z);
     }
-    return trafo_pt_vec;
+    return points;
 }
 
+/**
+ * @brief Transforms a batch of points, each output coordinate is computed in a separate loop without 
+ * dependencies between iterations, so the compiler can vectorize them
+ * 
+ * @param m 
+ * @param points 
+ * @param transformed 
+ */
+void transform_points(const Trafo &m, const PointsSoA &points, PointsSoA &transformed)
+{
+    const size_t num_pts = points.x.size();
+    transformed.x.resize(num_pts);
+    transformed.y.resize(num_pts);
+    transformed.z.resize(num_pts);
+    const tCoord *x = points.x.data();
+    const tCoord *y = points.y.data();
+    const tCoord *z = points.z.data();
+    tCoord *out_x = transformed.x.data();
+    tCoord *out_y = transformed.y.data();
+    tCoord *out_z = transformed.z.data();
+    for (size_t i=0; i<num_pts; ++i)
+    {
+        out_x[i] = m.xx * x[i] + m.xy * y[i] + m.xz * z[i] + m.tx;
+    }
+    for (size_t i=0; i<num_pts; ++i)
+    {
+        out_y[i] = m.yx * x[i] + m.yy * y[i] + m.yz * z[i] + m.ty;
+    }
+    for (size_t i=0; i<num_pts; ++i)
+    {
+        out_z[i] = m.zx * x[i] + m.zy * y[i] + m.zz * z[i] + m.tz;
+    }
+}
+
+void insert_points(const PointsSoA &points, FlatPointSet<tCoord> &point_set)
+{
+    for (size_t i=0; i<points.x.size(); ++i)
+    {
+        point_set.insert({ points.x[i], points.y[i], points.z[i] });
+    }
+}
 
 Point3D<tCoord> transform_point(const Trafo m, const Point3D<tCoord> &point)
 {
@@ -267,7 +558,7 @@ Point3D<tCoord> transform_point(const Trafo m, const Point3D<tCoord> &point)
 
 Trafo get_trafo(const std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> &overlap_pts)
 {
-    if (overlap_pts.size() < 12)
+    if (overlap_pts.size() < MIN_COMMON_BEACONS)
     {
         return {};
     }
@@ -279,7 +570,7 @@ Trafo get_trafo(const std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> &
     size_t ind{0};
     while (!(trafo_x_found && trafo_y_found && trafo_z_found))
     {
-        if (ind == overlap_pts.size())
+        if (ind + 1 >= overlap_pts.size())
         {
             throw std::runtime_error("Unable to find transformation matrix!");
         }
@@ -448,6 +739,213 @@ std::vector<std::pair<Point3D<tCoord>, Point3D<tCoord>>> get_overlapping_beacons
     return similar_pts;
 }
 
+/**
+ * @brief Finds the report pairs that share at least MIN_SHARED_DISTANCES distances by looking up the distances 
+ * of each report in the fingerprint index, and collects the colliding beacon pairs for each of them
+ * 
+ * @param index fingerprint index of all reports
+ * @return std::vector<ReportPairCollisions> candidate pairs sorted by (rep_1, rep_2) with rep_1 < rep_2
+ */
+std::vector<ReportPairCollisions> get_candidate_pairs(const DistanceIndex &index)
+{
+    std::vector<ReportPairCollisions> candidates;
+    std::vector<ReportPairCollisions> pair_collisions(index.num_reports()); ///< collisions of the current report with each later report
+    for (size_t rep_1=0; rep_1 < index.num_reports(); ++rep_1)
+    {
+        for (size_t rep_2=0; rep_2 < index.num_reports(); ++rep_2)
+        {
+            pair_collisions[rep_2] = { rep_1, rep_2, {} };
+        }
+        index.for_each_collision(rep_1, [&pair_collisions, rep_1](const BeaconPair &pair_1, const BeaconPair &pair_2){
+            if (rep_1 < pair_2.report) // every unordered report pair is collected once
+            {
+                pair_collisions[pair_2.report].collisions.emplace_back(pair_1, pair_2);
+            }
+        });
+        for (size_t rep_2=rep_1+1; rep_2 < index.num_reports(); ++rep_2)
+        {
+            if (pair_collisions[rep_2].collisions.size() >= MIN_SHARED_DISTANCES)
+            {
+                candidates.push_back(std::move(pair_collisions[rep_2]));
+            }
+        }
+    }
+    return candidates;
+}
+
+DistanceIndex::DistanceIndex(const std::vector<const std::vector<Point3D<tCoord>>*> &reports)
+{
+    m_offsets.push_back(0u);
+    for (size_t rep=0; rep < reports.size(); ++rep)
+    {
+        const std::vector<Point3D<tCoord>> &beacons = *reports[rep];
+        for (size_t b1=0; b1 < beacons.size(); ++b1)
+        {
+            for (size_t b2=b1+1; b2 < beacons.size(); ++b2)
+            {
+                m_pairs.push_back({ static_cast<std::uint32_t>(rep), static_cast<std::uint32_t>(b1), static_cast<std::uint32_t>(b2) });
+                m_dists.push_back(dist_squ<tCoord>(beacons[b2] - beacons[b1]));
+            }
+        }
+        m_offsets.push_back(m_pairs.size());
+    }
+    if (m_pairs.size() >= NO_ENTRY)
+    {
+        throw std::invalid_argument("Too many beacon pairs for the distance index!");
+    }
+
+    size_t capacity{ 16u };
+    while (capacity < 2u * m_pairs.size())
+    {
+        capacity *= 2u;
+    }
+    m_slot_dists.assign(capacity, -1); // squared distances are never negative
+    m_slot_heads.assign(capacity, NO_ENTRY);
+    m_next.assign(m_pairs.size(), NO_ENTRY);
+    for (std::uint32_t entry=0; entry < m_pairs.size(); ++entry)
+    {
+        const size_t slot = slot_of(m_dists[entry]);
+        m_slot_dists[slot] = m_dists[entry];
+        m_next[entry] = m_slot_heads[slot];
+        m_slot_heads[slot] = entry;
+    }
+}
+
+size_t DistanceIndex::num_reports() const
+{
+    return m_offsets.size() - 1u;
+}
+
+/**
+ * @brief Calls func(own_pair, other_pair) for each beacon pair of report rep and each beacon pair of 
+ * another report with the same distance
+ * 
+ * @param rep index of the report
+ * @param func 
+ */
+template<typename Func>
+void DistanceIndex::for_each_collision(const size_t rep, Func func) const
+{
+    for (size_t entry=m_offsets[rep]; entry < m_offsets[rep+1]; ++entry)
+    {
+        for (std::uint32_t other=m_slot_heads[slot_of(m_dists[entry])]; other != NO_ENTRY; other = m_next[other])
+        {
+            if (m_pairs[other].report != rep)
+            {
+                func(m_pairs[entry], m_pairs[other]);
+            }
+        }
+    }
+}
+
+size_t DistanceIndex::slot_of(const std::int32_t dist) const
+{
+    const size_t mask = m_slot_dists.size() - 1u;
+    size_t slot = static_cast<size_t>((static_cast<std::uint64_t>(dist) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (m_slot_dists[slot] != -1 && m_slot_dists[slot] != dist)
+    {
+        slot = (slot + 1u) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Finds the overlapping beacons of a candidate report pair from its fingerprint collisions. 
+ * A beacon of one report matches a beacon of the other report, if more than 10 of their distances to the 
+ * other beacons are equal (same criterion as get_overlapping_beacons).
+ * 
+ * @param pair_collisions 
+ * @param reports beacons of each report
+ * @return tOverlapPts matching beacons (rep_1, rep_2), sorted like the result of get_overlapping_beacons
+ */
+tOverlapPts get_overlapping_beacons_indexed(const ReportPairCollisions &pair_collisions, const std::vector<const std::vector<Point3D<tCoord>>*> &reports)
+{
+    constexpr std::uint32_t MIN_EQUAL_DISTANCES{ 11u };
+    const std::vector<Point3D<tCoord>> &beacons_1 = *reports[pair_collisions.rep_1];
+    const std::vector<Point3D<tCoord>> &beacons_2 = *reports[pair_collisions.rep_2];
+
+    // equal distances per beacon pair, key is beacon_1 * size of report 2 + beacon_2
+    std::unordered_map<std::uint64_t, std::uint32_t> votes;
+    const std::uint64_t size_2 = beacons_2.size();
+    for (const auto &collision : pair_collisions.collisions)
+    {
+        for (const std::uint64_t b1 : {collision.first.beacon_1, collision.first.beacon_2})
+        {
+            for (const std::uint64_t b2 : {collision.second.beacon_1, collision.second.beacon_2})
+            {
+                ++votes[b1 * size_2 + b2];
+            }
+        }
+    }
+
+    tOverlapPts similar_pts;
+    for (const auto &vote : votes)
+    {
+        if (vote.second >= MIN_EQUAL_DISTANCES)
+        {
+            similar_pts.push_back(std::make_pair(beacons_1[vote.first / size_2], beacons_2[vote.first % size_2]));
+        }
+    }
+    std::sort(similar_pts.begin(), similar_pts.end());
+    return similar_pts;
+}
+
+/**
+ * @brief Computes the transformation between two reports from their matching beacons and verifies it: 
+ * at least MIN_COMMON_BEACONS beacons of rep_2 have to be transformed onto their partners of rep_1. 
+ * Does not throw, so it can be called from pool workers; a failed alignment is returned as not aligned.
+ * 
+ * @param similar_pt_ids matching beacons (rep_1, rep_2)
+ * @return PairAlignment 
+ */
+PairAlignment align_overlap(const tOverlapPts &similar_pt_ids)
+{
+    if (similar_pt_ids.size() < MIN_COMMON_BEACONS)
+    {
+        return {};
+    }
+    Trafo trafo_2_to_1{};
+    try
+    {
+        trafo_2_to_1 = get_trafo(similar_pt_ids);
+    }
+    catch (const std::runtime_error &)
+    {
+        return {};
+    }
+    size_t num_matches{ 0 };
+    for (const auto &pts : similar_pt_ids)
+    {
+        if (transform_point(trafo_2_to_1, pts.second) == pts.first)
+        {
+            ++num_matches;
+        }
+    }
+    if (num_matches < MIN_COMMON_BEACONS)
+    {
+        return {};
+    }
+    return { true, trafo_2_to_1 };
+}
+
+/**
+ * @brief Inverts a transformation consisting of a rotation (orthogonal matrix) and a translation
+ * 
+ * @param trafo 
+ * @return Trafo 
+ */
+Trafo inverse(const Trafo &trafo)
+{
+    Trafo res{};
+    res.xx = trafo.xx; res.xy = trafo.yx; res.xz = trafo.zx;
+    res.yx = trafo.xy; res.yy = trafo.yy; res.yz = trafo.zy;
+    res.zx = trafo.xz; res.zy = trafo.yz; res.zz = trafo.zz;
+    res.tx = -(res.xx*trafo.tx + res.xy*trafo.ty + res.xz*trafo.tz);
+    res.ty = -(res.yx*trafo.tx + res.yy*trafo.ty + res.yz*trafo.tz);
+    res.tz = -(res.zx*trafo.tx + res.zy*trafo.ty + res.zz*trafo.tz);
+    return res;
+}
+
 bool fill_chain(std::map<std::string, std::vector<std::string>> &trafo_map, const std::map<std::string, std::vector<std::string>> &r_t_assignment, const std::string cur_system)
 {
     for (const auto &elem : r_t_assignment.at(cur_system))
@@ -496,41 +994,4 @@ std::map<std::string, std::vector<std::string>> get_transformation_chain(const s
     return trafo_map;
 }
 
-/**
- * @brief Transform all points given in scan_map to the coordinate system given in target_system
- * 
- * @param scan_map 
- * @param trafo_map Provides info about which report can be directly transformed to which other report 
- * @param report_trafo_assignment Provides info about the transformation matrix in order to transform points from one system to another
- * @param target_system 
- * @return std::map<std::string, std::vector<Point3D<tCoord>>> 
- */
-std::map<std::string, std::vector<Point3D<tCoord>>> transform_pts(
-    const std::map<std::string, std::vector<Point3D<tCoord>>> &scan_map, 
-    const std::map<std::string, std::vector<std::string>> &trafo_map, 
-    const std::map<std::string, std::map<std::string,Trafo>> &report_trafo_assignment, 
-    const std::string target_system)
-{
-    std::map<std::string, std::vector<Point3D<tCoord>>> transformed_scan_map;
-    transformed_scan_map[target_system] = scan_map.at(target_system);
-
-    for (const auto &rep_trafo_vec : trafo_map)
-    {
-        if (rep_trafo_vec.second.size() == 1) // vector for target system has size of 1
-        {
-            continue;
-        }
-        std::string start_system = rep_trafo_vec.first;
-        const std::vector<std::string> &trafos = rep_trafo_vec.second;
-        std::vector<Point3D<tCoord>> cur_pts = scan_map.at(start_system);
-        for (size_t i=trafos.size()-1; i>0; --i)
-        {
-            // Would have been faster to multiply transformation matrices and only transform points with final matrix
-             cur_pts = transform_points(report_trafo_assignment.at(trafos.at(i-1)).at(trafos.at(i)), cur_pts);
-        }
-        transformed_scan_map[start_system] = cur_pts;
-    }
-    return transformed_scan_map;
-}
-
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <vector>
+#include <cstdint>
+
+#include "../utility.h"
+
+/**
+ * @brief Hash set of 3D points with open addressing and linear probing. Points are stored inline in one
+ * contiguous vector (no node allocation per point), the capacity is a power of two and kept at least twice the size.
+ *
+ * @tparam T integral coordinate type
+ */
+template<typename T>
+class FlatPointSet
+{
+public:
+    explicit FlatPointSet(const size_t expected_size = 16u);
+    bool insert(const Point3D<T> &pt);
+    bool contains(const Point3D<T> &pt) const;
+    size_t size() const;
+    void reserve(const size_t expected_size);
+
+private:
+    size_t slot_of(const Point3D<T> &pt) const;
+    void rehash(const size_t capacity);
+
+    std::vector<Point3D<T>> m_points;
+    std::vector<std::uint8_t> m_is_used; ///< 1 if the slot holds a point
+    size_t m_size;
+};
+
+template<typename T>
+FlatPointSet<T>::FlatPointSet(const size_t expected_size) : m_size{ 0 }
+{
+    rehash(16u);
+    reserve(expected_size);
+}
+
+/**
+ * @brief Inserts pt if it is not already part of the set
+ *
+ * @param pt
+ * @return true, if pt was inserted
+ */
+template<typename T>
+bool FlatPointSet<T>::insert(const Point3D<T> &pt)
+{
+    if (2u * (m_size + 1u) > m_points.size())
+    {
+        rehash(2u * m_points.size());
+    }
+    const size_t slot = slot_of(pt);
+    if (m_is_used[slot])
+    {
+        return false;
+    }
+    m_points[slot] = pt;
+    m_is_used[slot] = 1u;
+    ++m_size;
+    return true;
+}
+
+template<typename T>
+bool FlatPointSet<T>::contains(const Point3D<T> &pt) const
+{
+    return m_is_used[slot_of(pt)] == 1u;
+}
+
+template<typename T>
+size_t FlatPointSet<T>::size() const
+{
+    return m_size;
+}
+
+template<typename T>
+void FlatPointSet<T>::reserve(const size_t expected_size)
+{
+    size_t capacity = m_points.size();
+    while (capacity < 2u * expected_size)
+    {
+        capacity *= 2u;
+    }
+    if (capacity != m_points.size())
+    {
+        rehash(capacity);
+    }
+}
+
+/**
+ * @brief Returns the slot holding pt or the free slot where pt would be inserted
+ *
+ * @param pt
+ * @return size_t
+ */
+template<typename T>
+size_t FlatPointSet<T>::slot_of(const Point3D<T> &pt) const
+{
+    std::uint64_t hash = static_cast<std::uint64_t>(pt.x);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(pt.y);
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<std::uint64_t>(pt.z);
+    hash = (hash ^ (hash >> 31)) * 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 29;
+
+    const size_t mask = m_points.size() - 1u;
+    size_t slot = static_cast<size_t>(hash) & mask;
+    while (m_is_used[slot] && !(m_points[slot] == pt))
+    {
+        slot = (slot + 1u) & mask;
+    }
+    return slot;
+}
+
+template<typename T>
+void FlatPointSet<T>::rehash(const size_t capacity)
+{
+    std::vector<Point3D<T>> old_points(capacity);
+    std::vector<std::uint8_t> old_is_used(capacity, 0u);
+    std::swap(old_points, m_points);
+    std::swap(old_is_used, m_is_used);
+    for (size_t i=0; i < old_points.size(); ++i)
+    {
+        if (old_is_used[i])
+        {
+            const size_t slot = slot_of(old_points[i]);
+            m_points[slot] = old_points[i];
+            m_is_used[slot] = 1u;
+        }
+    }
+}
@@ -3,9 +3,9 @@
 #include <fstream>
 
 #include "../utility.h"
+#include "bit_image_enhancer.h"
 
 constexpr size_t BORDER_EXT = 4u; ///< Denotes how many rows and columns are prepended/appended before/after the input data
-using Image = std::vector<std::vector<bool>>;
 
 struct sAlgoData
 {
@@ -15,6 +15,7 @@ struct sAlgoData
 
 // function declarations
 std::uint32_t day_20_1(const std::string &file_path);
+std::uint64_t enhance_image(const std::string &file_path, const size_t num_iterations, const size_t num_threads = 1u);
 sAlgoData get_input_image(const std::string &file_path);
 std::vector<bool> parse_string_to_bool_vec(const std::string &str_in, size_t ext_num=0);
 sAlgoData calc_output_image(const sAlgoData &image_in);
@@ -26,25 +27,37 @@ void print_image(std::ostream &out, const Image image);
 
 std::uint32_t day_20_1(const std::string &file_path)
 {
-    sAlgoData input_data = get_input_image(file_path);
-
-    sAlgoData output_data = calc_output_image(input_data);
-    sAlgoData output_data_2 = calc_output_image(output_data);
-
-    return num_lit_pixels(output_data_2.image_data);
+    return static_cast<std::uint32_t>(enhance_image(file_path, 2u));
 }
 
 std::uint32_t day_20_2(const std::string &file_path)
 {
-    sAlgoData input_data = get_input_image(file_path);
-    for (size_t i=0; i<50; ++i) 
-    {
-        input_data = calc_output_image(input_data);
-    }
     // too low: 5938
-    return num_lit_pixels(input_data.image_data);
+    return static_cast<std::uint32_t>(enhance_image(file_path, 50u));
+}
+
+/**
+ * @brief Applies the enhancement algorithm num_iterations times with the bit-packed BitImageEnhancer
+ * 
+ * @param file_path 
+ * @param num_iterations 
+ * @param num_threads number of threads, each calculates a band of rows per iteration
+ * @return std::uint64_t number of lit pixels in the output image
+ */
+std::uint64_t enhance_image(const std::string &file_path, const size_t num_iterations, const size_t num_threads)
+{
+    sAlgoData input_data = get_input_image(file_path);
+    BitImageEnhancer enhancer{input_data.enhancement_algo, input_data.image_data, num_iterations};
+    enhancer.enhance(num_iterations, num_threads);
+    return enhancer.num_lit_pixels();
 }
 
+/**
+ * @brief Reference implementation of a single enhancement step on the unpacked image (allocates a new image per step)
+ * 
+ * @param algo_data_in 
+ * @return sAlgoData 
+ */
 sAlgoData calc_output_image(const sAlgoData &algo_data_in)
 {
     sAlgoData data_out;
@@ -0,0 +1,321 @@
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <thread>
+
+#include "../utility.h"
+
+using Image = std::vector<std::vector<bool>>;
+
+/**
+ * @brief Image enhancement on bit-packed images (64 pixels per word, bit j of a word is column 64*w+j).
+ * Two buffers large enough for the final image are allocated once and swapped after each iteration.
+ * Each pixel is stored XOR the current value of the infinite background, so everything outside of the
+ * active region stays 0 independent of background flips and never needs to be rewritten.
+ */
+class BitImageEnhancer
+{
+public:
+    BitImageEnhancer(const std::vector<bool> &enhancement_algo, const Image &image_in, const size_t max_iterations);
+    void enhance(const size_t num_iterations, const size_t num_threads = 1u);
+    std::uint64_t num_lit_pixels() const;
+    Image get_image() const;
+
+private:
+    using Word = std::uint64_t;
+    static constexpr size_t WORD_BITS = 64u;
+    static constexpr size_t ALGO_SIZE = 512u;
+    static constexpr size_t CHUNK_BITS = 8u;
+
+    void prepare_iteration();
+    void finish_iteration();
+    void update_lut();
+    void enhance_rows(const size_t row_begin, const size_t row_end);
+    Word enhance_word(const Word *top, const Word *mid, const Word *bot, const size_t word) const;
+    static size_t get_chunk(const Word *row, const size_t word, const size_t chunk);
+    bool get_stored_pixel(const size_t row, const size_t col) const;
+
+    std::array<bool, ALGO_SIZE> m_algo; ///< enhancement algorithm, index built row by row (top left pixel is MSB)
+    std::array<std::uint8_t, ALGO_SIZE> m_lut; ///< algorithm for stored pixels, index built column by column (3 bits per column, left column and top pixel are LSB)
+    std::array<std::uint32_t, 1u << (CHUNK_BITS + 2u)> m_spread; ///< moves bit i of a 10 bit value to bit 3*i
+    std::vector<Word> m_image_in; ///< current image, row-major with m_words_per_row words per row
+    std::vector<Word> m_image_out; ///< output buffer of the next iteration
+    size_t m_num_rows;
+    size_t m_words_per_row;
+    size_t m_row_begin; ///< active region [m_row_begin, m_row_end) x [m_col_begin, m_col_end), outside only background
+    size_t m_row_end;
+    size_t m_col_begin;
+    size_t m_col_end;
+    size_t m_iterations_left; ///< remaining iterations the buffers are large enough for
+    bool m_background{ false }; ///< value of all pixels outside of the active region
+    bool m_background_out{ false }; ///< background after the running iteration
+};
+
+/**
+ * @brief Construct a new Bit Image Enhancer object
+ *
+ * @param enhancement_algo 512 entries
+ * @param image_in initial image, all pixels outside are dark
+ * @param max_iterations number of iterations the buffers are allocated for (image grows by one pixel per side and iteration)
+ */
+BitImageEnhancer::BitImageEnhancer(const std::vector<bool> &enhancement_algo, const Image &image_in, const size_t max_iterations)
+    : m_iterations_left{ max_iterations }
+{
+    if (enhancement_algo.size() != ALGO_SIZE)
+    {
+        throw std::invalid_argument("Enhancement algorithm must contain 512 entries!");
+    }
+    std::copy(enhancement_algo.begin(), enhancement_algo.end(), m_algo.begin());
+    for (size_t val=0; val < m_spread.size(); ++val)
+    {
+        m_spread[val] = 0u;
+        for (size_t bit=0; bit < CHUNK_BITS + 2u; ++bit)
+        {
+            m_spread[val] |= static_cast<std::uint32_t>((val >> bit) & 1u) << (3u*bit);
+        }
+    }
+    size_t rows_in = image_in.size();
+    size_t cols_in = image_in.empty() ? 0u : image_in[0].size();
+
+    // one guard row and one guard word on each side, so neighbors of the active region can always be read
+    m_row_begin = max_iterations + 1u;
+    m_row_end = m_row_begin + rows_in;
+    m_num_rows = m_row_end + max_iterations + 1u;
+    m_col_begin = WORD_BITS + max_iterations;
+    m_col_end = m_col_begin + cols_in;
+    m_words_per_row = (m_col_end + max_iterations + WORD_BITS - 1u) / WORD_BITS + 1u;
+
+    m_image_in.assign(m_num_rows * m_words_per_row, 0u);
+    m_image_out.assign(m_num_rows * m_words_per_row, 0u);
+    for (size_t row=0; row < rows_in; ++row)
+    {
+        for (size_t col=0; col < image_in[row].size(); ++col)
+        {
+            size_t buf_col = m_col_begin + col;
+            m_image_in[(m_row_begin + row) * m_words_per_row + buf_col / WORD_BITS] |= static_cast<Word>(image_in[row][col]) << (buf_col % WORD_BITS);
+        }
+    }
+}
+
+/**
+ * @brief Applies the enhancement algorithm num_iterations times. With more than one thread, the output rows of each 
+ * iteration are split into one band per thread and all threads wait at a barrier before the next iteration starts.
+ *
+ * @param num_iterations
+ * @param num_threads number of threads (including the calling thread)
+ */
+void BitImageEnhancer::enhance(const size_t num_iterations, const size_t num_threads)
+{
+    if (num_iterations > m_iterations_left)
+    {
+        throw std::invalid_argument("Image buffers are too small for the requested number of iterations!");
+    }
+    if (num_iterations == 0u)
+    {
+        return;
+    }
+    if (num_threads <= 1u)
+    {
+        for (size_t i=0; i < num_iterations; ++i)
+        {
+            prepare_iteration();
+            enhance_rows(m_row_begin, m_row_end);
+            finish_iteration();
+        }
+        return;
+    }
+
+    size_t num_finished{ 0 };
+    prepare_iteration();
+    Barrier barrier{num_threads, [this, &num_finished, num_iterations]() 
+    {
+        finish_iteration();
+        if (++num_finished < num_iterations)
+        {
+            prepare_iteration();
+        }
+    }};
+    auto enhance_band = [this, &barrier, num_iterations, num_threads](const size_t thread_idx)
+    {
+        for (size_t i=0; i < num_iterations; ++i)
+        {
+            size_t num_rows = m_row_end - m_row_begin;
+            enhance_rows(m_row_begin + num_rows * thread_idx / num_threads, m_row_begin + num_rows * (thread_idx+1u) / num_threads);
+            barrier.arrive_and_wait();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t thread_idx=1; thread_idx < num_threads; ++thread_idx)
+    {
+        workers.emplace_back(enhance_band, thread_idx);
+    }
+    enhance_band(0u);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Builds the lookup table and grows the active region by one pixel per side
+ */
+void BitImageEnhancer::prepare_iteration()
+{
+    update_lut();
+    --m_row_begin;
+    ++m_row_end;
+    --m_col_begin;
+    ++m_col_end;
+}
+
+/**
+ * @brief Makes the output of the iteration the new input image
+ */
+void BitImageEnhancer::finish_iteration()
+{
+    std::swap(m_image_in, m_image_out);
+    m_background = m_background_out;
+    --m_iterations_left;
+}
+
+/**
+ * @brief Builds the lookup table for the stored (background corrected) pixels of the next iteration.
+ * The index of m_lut contains the 3 columns of the 3x3 square (left column and top pixel of a column are LSB),
+ * so it is a sliding window over the column codes while moving from one column to the next.
+ */
+void BitImageEnhancer::update_lut()
+{
+    m_background_out = m_algo[m_background ? ALGO_SIZE-1u : 0u];
+    for (size_t col_idx=0; col_idx < ALGO_SIZE; ++col_idx)
+    {
+        size_t row_idx{ 0 };
+        for (size_t row=0; row < 3u; ++row)
+        {
+            for (size_t col=0; col < 3u; ++col)
+            {
+                bool pixel = (col_idx >> (3u*col + row)) & 1u;
+                row_idx = (row_idx << 1) | (pixel != m_background);
+            }
+        }
+        m_lut[col_idx] = static_cast<std::uint8_t>(m_algo[row_idx] != m_background_out);
+    }
+}
+
+/**
+ * @brief Calculates all words of the active columns for the output rows [row_begin, row_end)
+ *
+ * @param row_begin
+ * @param row_end
+ */
+void BitImageEnhancer::enhance_rows(const size_t row_begin, const size_t row_end)
+{
+    const size_t word_begin = m_col_begin / WORD_BITS;
+    const size_t word_end = (m_col_end + WORD_BITS - 1u) / WORD_BITS;
+    for (size_t row=row_begin; row < row_end; ++row)
+    {
+        const Word *top = &m_image_in[(row-1u) * m_words_per_row];
+        const Word *mid = top + m_words_per_row;
+        const Word *bot = mid + m_words_per_row;
+        Word *out = &m_image_out[row * m_words_per_row];
+        for (size_t word=word_begin; word < word_end; ++word)
+        {
+            out[word] = enhance_word(top, mid, bot, word);
+        }
+    }
+}
+
+/**
+ * @brief Calculates 64 output pixels in chunks of 8. For each chunk, 10 bits (chunk plus left and right neighbor)
+ * of the 3 input rows are spread to one 3 bit code per column, so the lookup index of each pixel is a 9 bit window of the codes.
+ *
+ * @param top input row above
+ * @param mid input row
+ * @param bot input row below
+ * @param word index of the word inside the rows
+ * @return Word 64 enhanced pixels
+ */
+BitImageEnhancer::Word BitImageEnhancer::enhance_word(const Word *top, const Word *mid, const Word *bot, const size_t word) const
+{
+    Word res{ 0u };
+    for (size_t chunk=0; chunk < WORD_BITS / CHUNK_BITS; ++chunk)
+    {
+        std::uint32_t codes = m_spread[get_chunk(top, word, chunk)]
+                            | (m_spread[get_chunk(mid, word, chunk)] << 1)
+                            | (m_spread[get_chunk(bot, word, chunk)] << 2);
+        Word res_chunk{ 0u };
+        for (size_t bit=0; bit < CHUNK_BITS; ++bit)
+        {
+            res_chunk |= static_cast<Word>(m_lut[(codes >> (3u*bit)) & (ALGO_SIZE-1u)]) << bit;
+        }
+        res |= res_chunk << (chunk * CHUNK_BITS);
+    }
+    return res;
+}
+
+/**
+ * @brief Returns the columns [8*chunk-1, 8*chunk+8] of a row as 10 bit value (left column is LSB)
+ *
+ * @param row
+ * @param word index of the word inside the row
+ * @param chunk index of the 8 bit chunk inside the word
+ * @return size_t
+ */
+size_t BitImageEnhancer::get_chunk(const Word *row, const size_t word, const size_t chunk)
+{
+    if (chunk == 0u)
+    {
+        return static_cast<size_t>(((row[word] << 1) | (row[word-1u] >> (WORD_BITS-1u))) & 0x3FFu);
+    }
+    if (chunk == WORD_BITS / CHUNK_BITS - 1u)
+    {
+        return static_cast<size_t>((row[word] >> (WORD_BITS - CHUNK_BITS - 1u)) | ((row[word+1u] & 1u) << (CHUNK_BITS + 1u)));
+    }
+    return static_cast<size_t>((row[word] >> (chunk * CHUNK_BITS - 1u)) & 0x3FFu);
+}
+
+bool BitImageEnhancer::get_stored_pixel(const size_t row, const size_t col) const
+{
+    return (m_image_in[row * m_words_per_row + col / WORD_BITS] >> (col % WORD_BITS)) & 1u;
+}
+
+/**
+ * @brief Number of lit pixels inside of the active region (i.e. the input image grown by one pixel per side and iteration)
+ *
+ * @return std::uint64_t
+ */
+std::uint64_t BitImageEnhancer::num_lit_pixels() const
+{
+    std::uint64_t num_set{ 0 };
+    for (size_t row=m_row_begin; row < m_row_end; ++row)
+    {
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            num_set += static_cast<std::uint64_t>(__builtin_popcountll(m_image_in[row * m_words_per_row + word]));
+        }
+    }
+    if (m_background)
+    {
+        return static_cast<std::uint64_t>(m_row_end - m_row_begin) * (m_col_end - m_col_begin) - num_set;
+    }
+    return num_set;
+}
+
+/**
+ * @brief Unpacks the active region, e.g. for print_image
+ *
+ * @return Image
+ */
+Image BitImageEnhancer::get_image() const
+{
+    Image image(m_row_end - m_row_begin, std::vector<bool>(m_col_end - m_col_begin));
+    for (size_t row=m_row_begin; row < m_row_end; ++row)
+    {
+        for (size_t col=m_col_begin; col < m_col_end; ++col)
+        {
+            image[row-m_row_begin][col-m_col_begin] = get_stored_pixel(row, col) != m_background;
+        }
+    }
+    return image;
+}
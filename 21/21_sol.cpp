@@ -51,11 +51,20 @@ std::uint64_t day_21_1(const std::string &file_path)
     }
 }
 
-std::uint64_t day_21_2(const std::string &file_path)
+/**
+ * @brief Number of universes in which the player winning more often wins
+ *
+ * @param file_path file holding the start positions
+ * @param win_score score at which a player wins
+ * @param board_size number of spaces of the circular track
+ * @param die_faces number of faces of the quantum die
+ * @return std::uint64_t 
+ */
+std::uint64_t day_21_2(const std::string &file_path, const std::uint16_t win_score=21u, const Position board_size=MAX_SPACE_VAL, const std::uint16_t die_faces=3u)
 {
     StartPos start_pos = get_start_pos(file_path);
 
-    QuantumDieController die{start_pos.pos_player_1, start_pos.pos_player_2, 21u};
+    QuantumDieController die{start_pos.pos_player_1, start_pos.pos_player_2, win_score, board_size, die_faces};
     
     std::uint64_t num_wins = die.play_game();
 
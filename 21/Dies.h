@@ -2,6 +2,9 @@
 #include <vector>
 #include <set>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
 
 constexpr std::uint8_t MAX_SPACE_VAL = 10u;
 
@@ -49,99 +52,141 @@ class QuantumDieController
 {
 public:
     using Steps = std::uint16_t;
-    using Score = std::uint16_t; // When a score >= 21 is reached the corresponding player wins
+    using Score = std::uint16_t; // When a score >= win_score is reached the corresponding player wins
     using Combos = std::uint64_t; // Tracks how many combinations exist for reaching a specific score
 
+    // combinations of all reachable (score, position) pairs of one player, stored densely as [score][position-1]
+    struct PlayerState
+    {
+        std::vector<Combos> combos;
+        Score min_score{ 0 }; ///< all rows below min_score are empty
+    };
+
     std::uint64_t play_game();
-    ThrowEvalSinglePlayer expand(std::map<Score, std::map<Position,Combos>> &state);
-    QuantumDieController(const Position pos_1, const Position pos_2, const Score win) : pos_player_1{ pos_1 }, pos_player_2{ pos_2 }, win_score{ win } {};
+    ThrowEvalSinglePlayer expand(PlayerState &state);
+    QuantumDieController(const Position pos_1, const Position pos_2, const Score win, const Position board = MAX_SPACE_VAL, const Steps faces = 3u);
 
 private:
-    ThrowEvalSinglePlayer expand_single_pos(const Score start_score, const Position start_pos, const Combos start_combo, std::map<Score, std::map<Position,Combos>> &state);
-    void fill_start_pos_2_end_pos_map();
-    Position advance_track(const Position start, const Steps steps);
+    static constexpr Steps ROLLS_PER_TURN = 3u;
+
+    static Combos add_combos(const Combos a, const Combos b);
+    static Combos mul_combos(const Combos a, const Combos b);
 
+    void fill_transitions();
+    Position advance_track(const Position start, const Steps steps) const;
+    void init_state(PlayerState &state, const Position start_pos) const;
 
-    const std::map<Steps, Combos> throw_combo_map{{3,1}, {4,3}, {5,6}, {6,7},
-                                                        {7,6}, {8,3}, {9,1}}; ///< maps the steps a player takes after rolling the quantum die thrice to the number of times this step number occurs 
-    std::map<Position, std::vector<std::pair<Position, Combos>>> start_pos_2_end_pos_map; ///< Stores for each start position which how many combinations each end position is reachable
+    std::vector<Combos> transitions; ///< [start_pos-1][end_pos-1] -> number of throw combinations moving a pawn from start_pos to end_pos
     std::uint64_t num_wins_player_1{ 0 };
     std::uint64_t num_wins_player_2{ 0 };
-    std::map<Score, std::map<Position,Combos>> state_1;
-    std::map<Score, std::map<Position,Combos>> state_2;
+    PlayerState state_1;
+    PlayerState state_2;
+    std::vector<Combos> state_new; ///< scratch buffer of expand, swapped with the expanded state
     Position pos_player_1;
     Position pos_player_2;
     const Score win_score;
+    const Position board_size;
+    const Steps die_faces;
 };
 
-ThrowEvalSinglePlayer QuantumDieController::expand(std::map<Score, std::map<Position,Combos>> &state)
+/**
+ * @brief Counts the universes of a game with a quantum die. Throws std::runtime_error if a number of universes
+ * exceeds the range of Combos, which happens for long games with many die faces.
+ *
+ * @param pos_1 start position of player 1 in [1, board]
+ * @param pos_2 start position of player 2 in [1, board]
+ * @param win score at which a player wins
+ * @param board number of spaces of the circular track
+ * @param faces number of faces of the die, it is rolled three times per turn
+ */
+QuantumDieController::QuantumDieController(const Position pos_1, const Position pos_2, const Score win, const Position board, const Steps faces)
+    : pos_player_1{ pos_1 }, pos_player_2{ pos_2 }, win_score{ win }, board_size{ board }, die_faces{ faces }
 {
-    ThrowEvalSinglePlayer eval{0,0};
-    std::map<Score, std::map<Position,Combos>> state_new;
-
-    for (const auto &score_elem : state)
+    if (win_score == 0u || board_size == 0u || die_faces == 0u)
     {
-        const auto &combo_pos_elem = score_elem.second;
-        const auto &start_score = score_elem.first;
-        for (const auto &combo_pos : combo_pos_elem)
-        {
-            const auto &start_combos = combo_pos.second;
-            const auto &pos = combo_pos.first;
-            ThrowEvalSinglePlayer eval_pos = expand_single_pos(start_score, pos, start_combos, state_new);
-            eval.num_wins += eval_pos.num_wins;
-            eval.num_not_wins += eval_pos.num_not_wins;
-        }
+        throw std::invalid_argument("Win score, board size and die faces must be positive!");
+    }
+    if (pos_1 == 0u || pos_1 > board_size || pos_2 == 0u || pos_2 > board_size)
+    {
+        throw std::invalid_argument("Start position not on the board!");
     }
-
-    state = state_new;
-    return eval;
 }
 
-
-ThrowEvalSinglePlayer QuantumDieController::expand_single_pos(const Score start_score, const Position start_pos, const Combos start_combo, std::map<Score, std::map<Position,Combos>> &state)
+/**
+ * @brief Executes one turn of a player for all universes, state is replaced by the states not yet won
+ *
+ * @param state 
+ * @return ThrowEvalSinglePlayer number of universes in which the player wins in this turn / has not won yet
+ */
+ThrowEvalSinglePlayer QuantumDieController::expand(PlayerState &state)
 {
     ThrowEvalSinglePlayer eval{0,0};
-    for (const auto &elem : start_pos_2_end_pos_map.at(start_pos))
+    std::fill(state_new.begin(), state_new.end(), 0u);
+    Score new_min_score = win_score;
+
+    for (size_t start_score=state.min_score; start_score<win_score; ++start_score)
     {
-        const Position &end_pos = elem.first;
-        const Combos &num_combos = elem.second;
-        Score new_score = start_score + end_pos;
-        Combos new_combos = start_combo * num_combos;
-        if (new_score >= win_score)
+        const Combos *row = state.combos.data() + start_score * board_size;
+        for (size_t start_pos=0; start_pos<board_size; ++start_pos)
         {
-            eval.num_wins += new_combos;
-            continue;
+            const Combos start_combos = row[start_pos];
+            if (start_combos == 0u)
+            {
+                continue;
+            }
+            const Combos *end_pos_combos = transitions.data() + start_pos * board_size;
+            for (size_t end_pos=0; end_pos<board_size; ++end_pos)
+            {
+                if (end_pos_combos[end_pos] == 0u)
+                {
+                    continue;
+                }
+                const size_t new_score = start_score + end_pos + 1u;
+                const Combos new_combos = mul_combos(start_combos, end_pos_combos[end_pos]);
+                if (new_score >= win_score)
+                {
+                    eval.num_wins = add_combos(eval.num_wins, new_combos);
+                    continue;
+                }
+                eval.num_not_wins = add_combos(eval.num_not_wins, new_combos); // bounds every entry of state_new, so these need no check
+                state_new[new_score * board_size + end_pos] += new_combos; // add number of combos to reach this score to already existing combinations
+                if (new_score < new_min_score)
+                {
+                    new_min_score = static_cast<Score>(new_score);
+                }
+            }
         }
-        eval.num_not_wins += new_combos;
-        state[new_score][end_pos] = state[new_score][end_pos] + new_combos; // add number of combos to reach this score to already existing combinations
     }
+
+    std::swap(state.combos, state_new);
+    state.min_score = new_min_score;
     return eval;
 }
 
 std::uint64_t QuantumDieController::play_game()
 {
-    fill_start_pos_2_end_pos_map();
-    state_1[0][pos_player_1] = 1u;
-    state_2[0][pos_player_2] = 1u;
-    // state_2[0] = std::make_pair(1u, std::set<Position>{pos_player_2});
+    fill_transitions();
+    init_state(state_1, pos_player_1);
+    init_state(state_2, pos_player_2);
+    state_new.assign(state_1.combos.size(), 0u);
     ThrowEvalSinglePlayer eval_player_1{ 0u,0u };
-    ThrowEvalSinglePlayer eval_player_2{ 0u,0u };
+    ThrowEvalSinglePlayer eval_player_2{ 0u,1u }; // before the first throw of player 2 there is a single universe
 
-    while(!state_1.empty() || !state_2.empty())
+    while(true)
     {
         eval_player_1 = expand(state_1);
-        num_wins_player_1 += eval_player_1.num_wins * eval_player_2.num_not_wins;
+        num_wins_player_1 = add_combos(num_wins_player_1, mul_combos(eval_player_1.num_wins, eval_player_2.num_not_wins));
 
-        if (state_1.empty()) // player 1 definitely wins in all cases after this throw
+        if (state_1.min_score == win_score) // player 1 definitely wins in all cases after this throw
         {
             break;
         }
 
         // Execute throw for player 2
         eval_player_2 = expand(state_2);
-        num_wins_player_2 += eval_player_2.num_wins*eval_player_1.num_not_wins;
+        num_wins_player_2 = add_combos(num_wins_player_2, mul_combos(eval_player_2.num_wins, eval_player_1.num_not_wins));
 
-        if (state_2.empty()) // player 2 definitely wins in all cases after this throw
+        if (state_2.min_score == win_score) // player 2 definitely wins in all cases after this throw
         {
             break;
         }
@@ -150,27 +195,73 @@ std::uint64_t QuantumDieController::play_game()
     return num_wins_player_1 > num_wins_player_2 ? num_wins_player_1 : num_wins_player_2;
 }
 
-void QuantumDieController::fill_start_pos_2_end_pos_map()
+void QuantumDieController::init_state(PlayerState &state, const Position start_pos) const
+{
+    state.combos.assign(static_cast<size_t>(win_score) * board_size, 0u);
+    state.combos[start_pos - 1u] = 1u;
+    state.min_score = 0u;
+}
+
+/**
+ * @brief Convolves the die distribution ROLLS_PER_TURN times to get the number of combinations of each step sum,
+ * the step sums are then folded onto the board, so the transition table has board_size x board_size entries
+ */
+void QuantumDieController::fill_transitions()
 {
-    for (Position start_pos=1u; start_pos<11; ++start_pos)
+    std::vector<Combos> throw_combos{ 1u }; ///< [steps] -> number of roll combinations summing up to steps
+    for (Steps roll=0; roll<ROLLS_PER_TURN; ++roll)
     {
-        for (const auto &die_throw : throw_combo_map)
+        std::vector<Combos> new_throw_combos(throw_combos.size() + die_faces, 0u);
+        for (size_t steps=0; steps<throw_combos.size(); ++steps)
         {
-            Position new_pos = advance_track(start_pos, die_throw.first);
-            start_pos_2_end_pos_map[start_pos].push_back(std::make_pair(new_pos, die_throw.second));
+            for (size_t face=1; face<=die_faces; ++face)
+            {
+                new_throw_combos[steps + face] += throw_combos[steps];
+            }
         }
+        throw_combos = std::move(new_throw_combos);
     }
+
+    transitions.assign(static_cast<size_t>(board_size) * board_size, 0u);
+    for (Position start_pos=1u; start_pos<=board_size; ++start_pos)
+    {
+        for (size_t steps=0; steps<throw_combos.size(); ++steps)
+        {
+            Position new_pos = advance_track(start_pos, static_cast<Steps>(steps % board_size));
+            transitions[(start_pos - 1u) * board_size + new_pos - 1u] += throw_combos[steps];
+        }
+    }
+}
+
+QuantumDieController::Combos QuantumDieController::add_combos(const Combos a, const Combos b)
+{
+    Combos res;
+    if (__builtin_add_overflow(a, b, &res))
+    {
+        throw std::runtime_error("Number of universes exceeds the range of the combination counter!");
+    }
+    return res;
+}
+
+QuantumDieController::Combos QuantumDieController::mul_combos(const Combos a, const Combos b)
+{
+    Combos res;
+    if (__builtin_mul_overflow(a, b, &res))
+    {
+        throw std::runtime_error("Number of universes exceeds the range of the combination counter!");
+    }
+    return res;
 }
 
-Position QuantumDieController::advance_track(const Position start, const Steps steps)
+Position QuantumDieController::advance_track(const Position start, const Steps steps) const
 {
-    Position new_pos = (static_cast<std::uint64_t>(start) + steps) % (MAX_SPACE_VAL);
+    Position new_pos = (static_cast<std::uint64_t>(start) + steps) % (board_size);
     if (new_pos == 0)
     {
-        return MAX_SPACE_VAL;
+        return board_size;
     }
     else
     {
         return new_pos;
     }
-}
\ No newline at end of file
+}
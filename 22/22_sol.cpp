@@ -1,20 +1,26 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <map>
+#include <tuple>
+#include <algorithm>
 
 #include "../utility.h"
 
-constexpr uint16_t SIZE = 50u; // Grid goes from -SIZE....SIZE
-constexpr uint16_t GRID_SIZE{ SIZE*2 + 1 }; // Array ranges from 0 to SIZE*2 + 1
+constexpr int64_t SIZE = 50; // Initialization region goes from -SIZE....SIZE in each dimension
 
 using pCoord = int64_t;
-using Grid = std::array<std::array<std::array<uint8_t, GRID_SIZE>, GRID_SIZE>, GRID_SIZE>;
 
 enum class InsType{
     ON,
     OFF,
 };
 
+enum class RebootEngine{
+    SPLIT, ///< splits each "on" cuboid into fragments not covered by any later instruction
+    SIGNED_VOLUMES, ///< inclusion-exclusion over a list of signed (added/subtracted) cuboids
+};
+
 struct Range
 {
     pCoord start;
@@ -26,8 +32,15 @@ struct Cuboid
     Range x;
     Range y;
     Range z;
+    bool operator<(const Cuboid &other) const;
 };
 
+bool Cuboid::operator<(const Cuboid &other) const
+{
+    return std::tie(x.start, x.end, y.start, y.end, z.start, z.end) 
+            < std::tie(other.x.start, other.x.end, other.y.start, other.y.end, other.z.start, other.z.end);
+}
+
 struct Instruction
 {
     InsType type;
@@ -36,28 +49,185 @@ struct Instruction
 
 void print_instructions(std::ostream &out, const std::vector<Instruction> &ins_vec);
 std::vector<Instruction> get_instructions(const std::string& file_path);
-std::vector<Instruction> trafo_instructions(const std::vector<Instruction> &ins_vec, const pCoord lower_lim, const pCoord upper_lim);
-void limit_point(Instruction &ins, const pCoord lower_lim, const pCoord upper_lim);
-bool is_in_range(Instruction &ins, const pCoord lower_lim, const pCoord upper_lim);
-void execute_instruction(const Instruction &ins, Grid &grid);
-uint64_t count_active_cubes(const Grid &grid);
 bool do_cuboids_intersect(const Cuboid &c1, const Cuboid &c2);
 std::vector<Range> get_not_intersecting_ranges_r1(const Range r1, const Range r2);
 std::vector<Cuboid> get_not_intersecting_cuboids(const Cuboid &c1, const Cuboid &c2);
 uint64_t count_active_cubes(const std::vector<Cuboid> &c_vec);
+uint64_t count_active_cubes_split(const std::vector<Instruction> &ins_vec);
+uint64_t count_active_cubes_signed(const std::vector<Instruction> &ins_vec);
+Cuboid get_intersection(const Cuboid &c1, const Cuboid &c2);
+int64_t get_volume(const Cuboid &c);
+uint64_t count_active_cubes_in_region(const std::vector<Instruction> &ins_vec, const Cuboid &region);
+Cuboid read_region(std::istream &region_in);
+
+/**
+ * @brief Bit-packed 3D grid of cubes covering a bounded region. Each (y,z) row of cubes is stored as consecutive 
+ * 64 bit words along x, so a cuboid is set or cleared with word-wide masks per row and counted with popcount.
+ */
+class BitGrid3D
+{
+public:
+    explicit BitGrid3D(const Cuboid &region);
+    void set(const Cuboid &cuboid, const bool value);
+    uint64_t count() const;
+
+private:
+    using Word = uint64_t;
+    static constexpr size_t WORD_BITS = 64u;
+
+    Cuboid m_region;
+    size_t m_size_x;
+    size_t m_size_y;
+    size_t m_words_per_row;
+    std::vector<Word> m_bits; ///< rows ordered by z, then y
+};
+
+BitGrid3D::BitGrid3D(const Cuboid &region) : m_region{region}
+{
+    if (region.x.end < region.x.start || region.y.end < region.y.start || region.z.end < region.z.start)
+    {
+        throw std::invalid_argument("Region of BitGrid3D is empty!");
+    }
+    m_size_x = static_cast<size_t>(region.x.end - region.x.start + 1);
+    m_size_y = static_cast<size_t>(region.y.end - region.y.start + 1);
+    size_t size_z = static_cast<size_t>(region.z.end - region.z.start + 1);
+    m_words_per_row = (m_size_x + WORD_BITS - 1u) / WORD_BITS;
+    m_bits.assign(m_words_per_row * m_size_y * size_z, 0u);
+}
+
+/**
+ * @brief Turns all cubes of cuboid on (value == true) or off. Parts of cuboid outside of the region are ignored
+ * 
+ * @param cuboid 
+ * @param value 
+ */
+void BitGrid3D::set(const Cuboid &cuboid, const bool value)
+{
+    if (!do_cuboids_intersect(cuboid, m_region))
+    {
+        return;
+    }
+    Cuboid c = get_intersection(cuboid, m_region);
+    size_t x_first = static_cast<size_t>(c.x.start - m_region.x.start);
+    size_t x_last = static_cast<size_t>(c.x.end - m_region.x.start);
+    size_t word_first = x_first / WORD_BITS;
+    size_t word_last = x_last / WORD_BITS;
+    Word mask_first = ~Word{0u} << (x_first % WORD_BITS);
+    Word mask_last = ~Word{0u} >> (WORD_BITS - 1u - x_last % WORD_BITS);
+    if (word_first == word_last)
+    {
+        mask_first &= mask_last;
+    }
+
+    for (pCoord z=c.z.start; z <= c.z.end; ++z)
+    {
+        for (pCoord y=c.y.start; y <= c.y.end; ++y)
+        {
+            size_t row = static_cast<size_t>(z - m_region.z.start) * m_size_y + static_cast<size_t>(y - m_region.y.start);
+            Word *words = &m_bits[row * m_words_per_row];
+            for (size_t word=word_first; word <= word_last; ++word)
+            {
+                Word mask = word == word_first ? mask_first : (word == word_last ? mask_last : ~Word{0u});
+                words[word] = value ? (words[word] | mask) : (words[word] & ~mask);
+            }
+        }
+    }
+}
+
+uint64_t BitGrid3D::count() const
+{
+    uint64_t sum{ 0u };
+    for (const auto word : m_bits)
+    {
+        sum += static_cast<uint64_t>(__builtin_popcountll(word));
+    }
+    return sum;
+}
 
-std::uint64_t day_22_1(const std::string &file_path)
+std::uint64_t day_22_1(const std::string &file_path, const pCoord region_size = SIZE)
 {
     std::vector<Instruction> ins_vec = get_instructions(file_path);
-    ins_vec = trafo_instructions(ins_vec, 0, 100);
-    // print_instructions(std::cout, ins_vec);
-    Grid grid{};
+    return count_active_cubes_in_region(ins_vec, { {-region_size, region_size}, {-region_size, region_size}, {-region_size, region_size} });
+}
+
+/**
+ * @brief Counts the active cubes in a region read from region_in, e.g. from the command line via std::cin
+ * 
+ * @param file_path 
+ * @param region_in stream providing the region, see read_region
+ * @return std::uint64_t 
+ */
+std::uint64_t day_22_1(const std::string &file_path, std::istream &region_in)
+{
+    const Cuboid region = read_region(region_in);
+    std::vector<Instruction> ins_vec = get_instructions(file_path);
+    return count_active_cubes_in_region(ins_vec, region);
+}
+
+/**
+ * @brief Reads a region from the first line of region_in. The line either holds a single size N
+ * for the region -N..N in each dimension or the ranges in instruction format "x=a..b,y=c..d,z=e..f"
+ * 
+ * @param region_in 
+ * @return Cuboid 
+ */
+Cuboid read_region(std::istream &region_in)
+{
+    std::string input_line;
+    if (!getline(region_in, input_line))
+    {
+        throw std::invalid_argument("No region received!");
+    }
+    const std::vector<pCoord> num_vec = parse_string_to_number_vec<pCoord>(input_line);
+    Cuboid region{};
+    if (num_vec.size() == 1u && num_vec[0] >= 0)
+    {
+        region = { {-num_vec[0], num_vec[0]}, {-num_vec[0], num_vec[0]}, {-num_vec[0], num_vec[0]} };
+    }
+    else if (num_vec.size() == 6u)
+    {
+        region = { {num_vec[0], num_vec[1]}, {num_vec[2], num_vec[3]}, {num_vec[4], num_vec[5]} };
+    }
+    else
+    {
+        throw std::invalid_argument("Invalid region received: " + input_line);
+    }
+    if (region.x.start > region.x.end || region.y.start > region.y.end || region.z.start > region.z.end)
+    {
+        throw std::invalid_argument("Empty region received: " + input_line);
+    }
+    return region;
+}
+
+/**
+ * @brief Executes all instructions on a bit grid covering region and counts the active cubes
+ * 
+ * @param ins_vec 
+ * @param region bounded region, everything outside is ignored
+ * @return uint64_t 
+ */
+uint64_t count_active_cubes_in_region(const std::vector<Instruction> &ins_vec, const Cuboid &region)
+{
+    BitGrid3D grid{region};
     for (const auto &ins : ins_vec)
     {
-        execute_instruction(ins, grid);
+        grid.set(ins.cuboid, InsType::ON == ins.type);
     }
+    return grid.count();
+}
 
-    return count_active_cubes(grid);
+std::uint64_t day_22_2(const std::string &file_path, const RebootEngine engine = RebootEngine::SPLIT)
+{
+    std::vector<Instruction> ins_vec = get_instructions(file_path);
+    switch (engine)
+    {
+        case RebootEngine::SPLIT:
+            return count_active_cubes_split(ins_vec);
+        case RebootEngine::SIGNED_VOLUMES:
+            return count_active_cubes_signed(ins_vec);
+        default:
+            throw std::runtime_error("Unknown reboot engine received!");
+    }
 }
 
 /*
@@ -67,33 +237,99 @@ with any following "on" or "off" cube they are counted to the sum of active grid
 If they intersect with a following "on" cuboid they will be counted later on, if they intersect 
 with an "off"-cuboid they will not be counted.
 */
-std::uint64_t day_22_2(const std::string &file_path)
+uint64_t count_active_cubes_split(const std::vector<Instruction> &ins_vec)
 {
     uint64_t sum{ 0u };
-    std::vector<Instruction> ins_vec = get_instructions(file_path);
+    std::vector<Cuboid> cuboids;
+    for (const auto &ins : ins_vec)
+    {
+        cuboids.push_back(ins.cuboid);
+    }
+    BoxIndex<Cuboid> cuboid_index{cuboids};
+    std::vector<size_t> overlapping;
+    std::vector<Cuboid> not_intersecting_cuboids;
+    std::vector<Cuboid> new_not_intersecting_cuboids;
     for (size_t i=0; i<ins_vec.size(); ++i)
     {
         if (ins_vec[i].type == InsType::OFF) 
         {
             continue;
         }
-        std::vector<Cuboid> not_intersecting_cuboids{ ins_vec[i].cuboid };
-        for (size_t j=i+1; j<ins_vec.size(); ++j)
+        // all fragments are part of cuboid i, so only later instructions overlapping cuboid i can split them
+        overlapping.clear();
+        cuboid_index.query(cuboids[i], overlapping);
+        std::sort(overlapping.begin(), overlapping.end());
+        not_intersecting_cuboids.assign(1u, ins_vec[i].cuboid);
+        for (auto it = std::upper_bound(overlapping.begin(), overlapping.end(), i); it != overlapping.end() && !not_intersecting_cuboids.empty(); ++it)
         {
-            std::vector<Cuboid> new_not_intersecting_cuboids;
-
+            new_not_intersecting_cuboids.clear();
             for (const auto &c : not_intersecting_cuboids)
             {
-                auto tmp = get_not_intersecting_cuboids(c, ins_vec[j].cuboid);
+                auto tmp = get_not_intersecting_cuboids(c, ins_vec[*it].cuboid);
                 new_not_intersecting_cuboids.insert(new_not_intersecting_cuboids.end(), tmp.begin(), tmp.end());
             }
-            not_intersecting_cuboids = new_not_intersecting_cuboids;
+            not_intersecting_cuboids.swap(new_not_intersecting_cuboids); // keep both buffers instead of copying
         }
         sum += count_active_cubes(not_intersecting_cuboids);
     }
     return sum;
 }
 
+/*
+Inclusion-exclusion: every instruction first cancels its intersection with all cuboids counted so far 
+(intersection is added with the opposite sign), "on" instructions then add their own cuboid. 
+Equal cuboids are merged in a map, so the list only grows with the number of distinct intersections.
+*/
+uint64_t count_active_cubes_signed(const std::vector<Instruction> &ins_vec)
+{
+    std::map<Cuboid, int64_t> signed_cuboids; // cuboid -> how often its volume is added (negative: subtracted)
+    std::vector<std::pair<Cuboid, int64_t>> updates;
+    for (const auto &ins : ins_vec)
+    {
+        updates.clear();
+        for (const auto &elem : signed_cuboids)
+        {
+            if (do_cuboids_intersect(elem.first, ins.cuboid))
+            {
+                updates.push_back({ get_intersection(elem.first, ins.cuboid), -elem.second });
+            }
+        }
+        if (InsType::ON == ins.type)
+        {
+            updates.push_back({ ins.cuboid, 1 });
+        }
+        for (const auto &update : updates)
+        {
+            auto it = signed_cuboids.insert({ update.first, 0 }).first;
+            it->second += update.second;
+            if (it->second == 0)
+            {
+                signed_cuboids.erase(it);
+            }
+        }
+    }
+
+    int64_t sum{ 0 };
+    for (const auto &elem : signed_cuboids)
+    {
+        sum += elem.second * get_volume(elem.first);
+    }
+    return static_cast<uint64_t>(sum);
+}
+
+// c1 and c2 have to intersect
+Cuboid get_intersection(const Cuboid &c1, const Cuboid &c2)
+{
+    return { { std::max(c1.x.start, c2.x.start), std::min(c1.x.end, c2.x.end) },
+             { std::max(c1.y.start, c2.y.start), std::min(c1.y.end, c2.y.end) },
+             { std::max(c1.z.start, c2.z.start), std::min(c1.z.end, c2.z.end) } };
+}
+
+int64_t get_volume(const Cuboid &c)
+{
+    return (c.x.end - c.x.start + 1) * (c.y.end - c.y.start + 1) * (c.z.end - c.z.start + 1);
+}
+
 /* returns a vector of cuboids of c1 that are not part of c2 
 Up to 6 new cuboids are returned 
 */
@@ -160,7 +396,7 @@ uint64_t count_active_cubes(const std::vector<Cuboid> &c_vec)
     uint64_t sum{ 0u };
     for (const auto &c : c_vec)
     {
-        sum += (c.x.end - c.x.start + 1) * (c.y.end - c.y.start + 1) * (c.z.end - c.z.start + 1);
+        sum += get_volume(c);
     }
     return sum;
 }
@@ -174,87 +410,6 @@ bool do_cuboids_intersect(const Cuboid &c1, const Cuboid &c2)
     return true;
 }
 
-void execute_instruction(const Instruction &ins, Grid &grid)
-{
-    uint8_t t{ 0u };
-    if (InsType::ON == ins.type)
-    {
-        t = 1u;
-    }
-    for (auto x=ins.cuboid.x.start; x<=ins.cuboid.x.end; ++x)
-    {
-        for (auto y=ins.cuboid.y.start; y<=ins.cuboid.y.end; ++y)
-        {
-            for (auto z=ins.cuboid.z.start; z<=ins.cuboid.z.end; ++z)
-            {
-                grid[x][y][z] = t;
-            }
-        }
-    }
-}
-
-// Limit and transform instructions so they fit the grid size
-std::vector<Instruction> trafo_instructions(const std::vector<Instruction> &ins_vec, const pCoord lower_lim, const pCoord upper_lim)
-{
-    std::vector<Instruction> limited_ins_vec;
-    for (const auto &ins : ins_vec)
-    {
-        Instruction new_ins{ ins };
-        new_ins.cuboid.x.start += SIZE;
-        new_ins.cuboid.x.end += SIZE;
-        new_ins.cuboid.y.start += SIZE;
-        new_ins.cuboid.y.end += SIZE;
-        new_ins.cuboid.z.start += SIZE;
-        new_ins.cuboid.z.end += SIZE;
-        if (is_in_range(new_ins, lower_lim, upper_lim))
-        {
-            limit_point(new_ins, lower_lim, upper_lim);
-            limited_ins_vec.push_back(new_ins);
-        }
-    }
-    return limited_ins_vec;
-}
-
-void limit_point(Instruction &ins, const pCoord lower_lim, const pCoord upper_lim)
-{
-    if (ins.cuboid.x.start < lower_lim) ins.cuboid.x.start = lower_lim;
-    if (ins.cuboid.y.start < lower_lim) ins.cuboid.y.start = lower_lim;
-    if (ins.cuboid.z.start < lower_lim) ins.cuboid.z.start = lower_lim;
-    if (ins.cuboid.x.end > upper_lim) ins.cuboid.x.end = upper_lim;
-    if (ins.cuboid.y.end > upper_lim) ins.cuboid.y.end = upper_lim;
-    if (ins.cuboid.z.end > upper_lim) ins.cuboid.z.end = upper_lim;
-}
-
-bool is_in_range(Instruction &ins, const pCoord lower_lim, const pCoord upper_lim)
-{
-    if (ins.cuboid.x.end < lower_lim) return false;
-    if (ins.cuboid.y.end < lower_lim) return false;
-    if (ins.cuboid.z.end < lower_lim) return false;
-    if (ins.cuboid.x.start > upper_lim) return false;
-    if (ins.cuboid.y.start > upper_lim) return false;
-    if (ins.cuboid.z.start > upper_lim) return false;
-    return true;
-}
-
-uint64_t count_active_cubes(const Grid &grid)
-{
-    uint64_t sum{ 0u };
-    for (size_t x=0; x<grid.size(); ++x)
-    {
-        for (size_t y=0; y<grid.at(0).size(); ++y)
-        {
-            for (size_t z=0; z<grid.at(0).at(0).size(); ++z)
-            {
-                if (grid[x][y][z])
-                {
-                    ++sum;
-                }
-            }
-        }
-    }
-    return sum;
-}
-
 void print_instructions(std::ostream &out, const std::vector<Instruction> &ins_vec)
 {
     for (const auto &ins : ins_vec)
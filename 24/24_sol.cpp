@@ -3,8 +3,10 @@
 #include <vector>
 #include <array>
 #include <limits>
+#include <algorithm>
 
 #include "../utility.h"
+#include "z_frontier.h"
 
 /*
 The only value that gets transferred between the multiple 
@@ -28,18 +30,11 @@ Approach 2:
     should be applicable
 */
 
-// pair of (valio) w and z values that serve as input to a single
-// digit check of the 14 digit model number
-struct ValidWZPair{
-    int w;
-    int z;
-};
-
 // state containing the concatenated valid values for w
 // and the z value for the next digit check
 struct IntermediateState{
     uint64_t i_model_num{ 0 };
-    int z{ 0 };
+    int64_t z{ 0 };
 };
 
 /**
@@ -63,41 +58,80 @@ const std::map<std::string,InsType> type_map{   {"add", InsType::Add},
                                                 {"eql", InsType::Equal}, 
                                                 {"inp", InsType::Input}};
 
+enum class MonadSolver{
+    DIVIDE_26, ///< relies on the div z 26 structure of the puzzle input to discard states
+    Z_FRONTIER, ///< generic search over all digits, states are merged by z keeping the min/max prefix
+};
+
+constexpr size_t NUM_REGS{ 4 }; ///< registers w, x, y, z
+using Registers = std::array<int64_t, NUM_REGS>;
+
+/**
+ * @brief maps register char ['w','x','y','z'] to its index in Registers
+ */
+constexpr std::uint8_t reg_idx(const char reg)
+{
+    return static_cast<std::uint8_t>(reg - 'w');
+}
+
+// second operand, decoded once while reading the program
+struct Operand {
+    bool is_reg{ false }; ///< true if the operand is a register, false if it is an immediate value
+    std::uint8_t reg{ 0 }; ///< register index (only valid if is_reg)
+    int64_t imm{ 0 }; ///< immediate value (only valid if !is_reg)
+
+    bool operator==(const Operand &op) const{
+        return is_reg==op.is_reg && (is_reg ? reg==op.reg : imm==op.imm);
+    }
+};
+
 // structure for instruction representation in code
 struct Instruction {
     InsType ins_type{ }; ///< type of instruction
-    char a{ }; ///< char for the first operand
-    std::string b{ }; ///< string for the second operand (can be an integer or char ['w','x','y','z'])
+    std::uint8_t a{ }; ///< register index of the first operand
+    Operand b{ }; ///< second operand (register or immediate, unused for Input)
 
     bool operator==(const Instruction &ins) const{
-        return ins_type==ins.ins_type && a==ins.a && b==ins.b;
+        return ins_type==ins.ins_type && a==ins.a && (ins_type == InsType::Input || b==ins.b);
     }
 };
 
-// class for executing the instructions
+// class for executing the pre-decoded instructions on a register file
 struct ALU{
-    std::map<char, int> vars{ {'x',0}, {'y',0}, 
-                              {'w',0}, {'z',0} };
-    void do_instruction(char a, char b, InsType ins_type);
-    void do_instruction(char a, int b, InsType ins_type);
+    Registers regs{};
+    void do_instruction(const Instruction &ins, const int64_t input);
+    void run(const std::vector<Instruction> &ins_vec, const int64_t input);
+};
+
+// class for executing the pre-decoded instructions on many states at once,
+// registers are stored as structure of arrays so each instruction becomes a vectorizable loop over all lanes
+struct BatchALU{
+    std::array<std::vector<int64_t>, NUM_REGS> regs{};
+    void reset(const std::vector<int64_t> &z_vec);
+    void run(const std::vector<Instruction> &ins_vec, const int64_t input);
+
+private:
+    template<typename Op>
+    void apply(const Instruction &ins, Op op);
+};
+
+// closed interval [lo, hi] of values a register can hold
+struct Interval{
+    int64_t lo;
+    int64_t hi;
+    bool intersects(const Interval &other) const{
+        return lo <= other.hi && other.lo <= hi;
+    }
 };
 
 //function declarations
-/**
- * @brief Executes the instruction set ins_vec with a given z value and all
- * valid w values [1,...,9]
- * 
- * @param z start value for z before executing ins_vec
- * @param ins_vec vector of instructions
- * @return ValidWZPair pair of w and z, where w was used as input to get the corresponding z value
- */
-std::vector<ValidWZPair> get_valid_z_values(int z, const std::vector<Instruction> &ins_vec);
+Operand parse_operand(const std::string &str);
 
 /**
- * @brief read in instructions from data file
+ * @brief read in instructions from data file and decode them. Each block starts with its inp instruction
  * 
  * @param file_path 
- * @return std::vector<std::vector<Instruction>> 
+ * @return std::vector<std::vector<Instruction>> one block of instructions per input digit
  */
 std::vector<std::vector<Instruction>> read_data(const std::string &file_path);
 
@@ -112,8 +146,8 @@ bool does_contain_divide_26(const std::vector<Instruction> &ins_vec);
 
 /**
  * @brief Reduces the vector of valid states by only keeping those that fulfill the condition
- * stated in the ins_vec ((z%26)-<some_val> == w). <some_val> can be taken from the fourth
- * instruction of ins_vec
+ * stated in the ins_vec ((z%26)-<some_val> == w). <some_val> can be taken from the instruction
+ * "add x <some_val>", which is ins_vec[5] as each block starts with its inp instruction
  * 
  * @param pos current index in overall model number
  * @param valid_states valid input states
@@ -122,10 +156,80 @@ bool does_contain_divide_26(const std::vector<Instruction> &ins_vec);
  */
 std::vector<IntermediateState> reduce_valid_states(int pos, std::vector<IntermediateState> &valid_states, const std::vector<Instruction> &ins_vec);
 
-std::pair<std::uint64_t,std::uint64_t> day_24_1_2(const std::string &file_path)
+/**
+ * @brief Searches the smallest and largest valid model number using the div z 26 shortcut
+ * 
+ * @param ins_vec instruction blocks
+ * @return std::pair<std::uint64_t,std::uint64_t> smallest and largest valid model number
+ */
+std::pair<std::uint64_t,std::uint64_t> find_model_numbers_divide_26(const std::vector<std::vector<Instruction>> &ins_vec);
+
+/**
+ * @brief Searches the smallest and largest valid model number for a generic program, assuming
+ * only z is carried from one instruction block to the next. The frontier after each block holds
+ * every reachable z once with the smallest and largest prefix reaching it.
+ * 
+ * @param ins_vec instruction blocks
+ * @return std::pair<std::uint64_t,std::uint64_t> smallest and largest valid model number
+ */
+std::pair<std::uint64_t,std::uint64_t> find_model_numbers_frontier(const std::vector<std::vector<Instruction>> &ins_vec);
+
+/**
+ * @brief Abstract interpretation of a single instruction over intervals
+ * 
+ * @param ins_type 
+ * @param a interval of the first operand
+ * @param b interval of the second operand
+ * @return Interval containing every result of a <ins_type> b, bounds saturate at the int64_t range
+ */
+Interval eval_interval(const InsType ins_type, const Interval &a, const Interval &b);
+
+/**
+ * @brief Abstract interpretation of an instruction block, w, x and y start at 0 like in the concrete search
+ * 
+ * @param ins_vec instructions
+ * @param z interval of z before the block
+ * @param input interval of the values read by inp
+ * @return Interval containing every z after the block
+ */
+Interval analyze_block(const std::vector<Instruction> &ins_vec, const Interval &z, const Interval &input);
+
+/**
+ * @brief Computes for each block the range of z values before the block that may still lead to z == 0
+ * after the last block. States outside of the range can be discarded without evaluating them.
+ * Ranges are narrowed from both sides by a binary search on the bound, which is valid since
+ * interval evaluation is monotone with respect to inclusion.
+ * 
+ * @param ins_vec instruction blocks
+ * @return std::vector<Interval> viable z range before each block
+ */
+std::vector<Interval> get_viable_z_ranges(const std::vector<std::vector<Instruction>> &ins_vec);
+
+/**
+ * @brief Executes ins_vec for all valid states and all w values [1,...,9] using a batched ALU
+ * 
+ * @param valid_states valid input states
+ * @param ins_vec instructions
+ * @return std::vector<IntermediateState> 9 new states per input state
+ */
+std::vector<IntermediateState> expand_valid_states(const std::vector<IntermediateState> &valid_states, const std::vector<Instruction> &ins_vec);
+
+std::pair<std::uint64_t,std::uint64_t> day_24_1_2(const std::string &file_path, const MonadSolver solver = MonadSolver::DIVIDE_26)
 {
     std::vector<std::vector<Instruction>> ins_vec = read_data(file_path);
-    std::vector<std::vector<int>> valid_model_numbers;
+    switch (solver)
+    {
+        case MonadSolver::DIVIDE_26:
+            return find_model_numbers_divide_26(ins_vec);
+        case MonadSolver::Z_FRONTIER:
+            return find_model_numbers_frontier(ins_vec);
+        default:
+            throw std::runtime_error("Unknown MONAD solver received!");
+    }
+}
+
+std::pair<std::uint64_t,std::uint64_t> find_model_numbers_divide_26(const std::vector<std::vector<Instruction>> &ins_vec)
+{
     std::vector<IntermediateState> valid_states{ {{}, 0} };
 
     // for (const auto &ins_set : ins_vec)
@@ -139,19 +243,7 @@ std::pair<std::uint64_t,std::uint64_t> day_24_1_2(const std::string &file_path)
             continue;
         }
 
-        std::vector<IntermediateState> new_valid_states;
-        for (const auto &state : valid_states)
-        {
-            std::vector<ValidWZPair> valid_pairs = get_valid_z_values(state.z, ins_set);
-            for (const auto &valid_pair : valid_pairs)
-            {
-                auto new_state{ state };
-                new_state.i_model_num *= 10;
-                new_state.i_model_num += valid_pair.w;
-                new_state.z = valid_pair.z;
-                new_valid_states.push_back(new_state);
-            }
-        }
+        std::vector<IntermediateState> new_valid_states = expand_valid_states(valid_states, ins_set);
         valid_states = new_valid_states;
         // --pos;
     }
@@ -174,12 +266,195 @@ std::pair<std::uint64_t,std::uint64_t> day_24_1_2(const std::string &file_path)
     return { smallest_model_num,largest_model_num };
 }
 
+std::pair<std::uint64_t,std::uint64_t> find_model_numbers_frontier(const std::vector<std::vector<Instruction>> &ins_vec)
+{
+    const std::vector<Interval> viable_z = get_viable_z_ranges(ins_vec);
+    ZFrontier frontier{};
+    frontier.insert(0, 0, 0);
+    BatchALU alu{};
+    std::vector<int64_t> z_vec;
+    std::vector<std::uint64_t> min_prefixes;
+    std::vector<std::uint64_t> max_prefixes;
+
+    for (size_t pos=0; pos < ins_vec.size(); ++pos)
+    {
+        const auto &ins_set = ins_vec[pos];
+        z_vec.clear();
+        min_prefixes.clear();
+        max_prefixes.clear();
+        frontier.for_each([&](const ZFrontier::Entry &entry){
+            if (entry.z < viable_z[pos].lo || entry.z > viable_z[pos].hi)
+            {
+                return; // z can not reach 0 anymore
+            }
+            z_vec.push_back(entry.z);
+            min_prefixes.push_back(entry.min_prefix);
+            max_prefixes.push_back(entry.max_prefix);
+        });
+
+        ZFrontier new_frontier{ z_vec.size() };
+        for (int w=1; w < 10; ++w)
+        {
+            alu.reset(z_vec);
+            alu.run(ins_set, w);
+            const std::vector<int64_t> &new_z_vec = alu.regs[reg_idx('z')];
+            for (size_t i=0; i < z_vec.size(); ++i)
+            {
+                new_frontier.insert(new_z_vec[i], min_prefixes[i] * 10 + w, max_prefixes[i] * 10 + w);
+            }
+        }
+        frontier = std::move(new_frontier);
+    }
+
+    const ZFrontier::Entry *valid = frontier.find(0);
+    if (valid == nullptr)
+    {
+        throw std::runtime_error("No valid model number found!");
+    }
+    return { valid->min_prefix, valid->max_prefix };
+}
+
+std::vector<Interval> get_viable_z_ranges(const std::vector<std::vector<Instruction>> &ins_vec)
+{
+    const Interval input{ 1, 9 };
+    std::vector<Interval> reachable_z{ {0, 0} };
+    for (const auto &ins_set : ins_vec)
+    {
+        reachable_z.push_back(analyze_block(ins_set, reachable_z.back(), input));
+    }
+
+    std::vector<Interval> viable_z(ins_vec.size() + 1, Interval{ 0, 0 });
+    for (size_t pos=ins_vec.size(); pos-- > 0; )
+    {
+        const Interval reachable = reachable_z[pos];
+        const Interval target = viable_z[pos+1];
+        auto can_reach_target = [&](const Interval &z){ 
+            return analyze_block(ins_vec[pos], z, input).intersects(target); 
+        };
+        if (!can_reach_target(reachable))
+        {
+            throw std::runtime_error("No valid model number found!");
+        }
+
+        // smallest hi so that [hi+1, reachable.hi] can not reach the target
+        int64_t lo_bound{ reachable.lo };
+        int64_t hi_bound{ reachable.hi };
+        while (lo_bound < hi_bound)
+        {
+            int64_t mid = static_cast<int64_t>(lo_bound + (static_cast<__int128>(hi_bound) - lo_bound) / 2); // the difference overflows int64 for a saturated interval
+            if (can_reach_target({ mid + 1, reachable.hi }))
+            {
+                lo_bound = mid + 1;
+            }
+            else
+            {
+                hi_bound = mid;
+            }
+        }
+        const int64_t viable_hi{ hi_bound };
+
+        // largest lo so that [reachable.lo, lo-1] can not reach the target
+        lo_bound = reachable.lo;
+        hi_bound = viable_hi;
+        while (lo_bound < hi_bound)
+        {
+            int64_t mid = static_cast<int64_t>(hi_bound - (static_cast<__int128>(hi_bound) - lo_bound) / 2);
+            if (can_reach_target({ reachable.lo, mid - 1 }))
+            {
+                hi_bound = mid - 1;
+            }
+            else
+            {
+                lo_bound = mid;
+            }
+        }
+        viable_z[pos] = { lo_bound, viable_hi };
+    }
+    viable_z.pop_back();
+    return viable_z;
+}
+
+Interval analyze_block(const std::vector<Instruction> &ins_vec, const Interval &z, const Interval &input)
+{
+    std::array<Interval, NUM_REGS> regs{ Interval{0, 0}, Interval{0, 0}, Interval{0, 0}, Interval{0, 0} };
+    regs[reg_idx('z')] = z;
+    for (const auto &ins : ins_vec)
+    {
+        if (ins.ins_type == InsType::Input)
+        {
+            regs[ins.a] = input;
+            continue;
+        }
+        const Interval b = ins.b.is_reg ? regs[ins.b.reg] : Interval{ ins.b.imm, ins.b.imm };
+        regs[ins.a] = eval_interval(ins.ins_type, regs[ins.a], b);
+    }
+    return regs[reg_idx('z')];
+}
+
+Interval eval_interval(const InsType ins_type, const Interval &a, const Interval &b)
+{
+    using Wide = __int128;
+    auto saturate = [](const Wide lo, const Wide hi){
+        const Wide min = std::numeric_limits<int64_t>::min();
+        const Wide max = std::numeric_limits<int64_t>::max();
+        return Interval{ static_cast<int64_t>(std::clamp(lo, min, max)), static_cast<int64_t>(std::clamp(hi, min, max)) };
+    };
+    auto abs_max = [](const Interval &i){ 
+        return std::max(-static_cast<Wide>(i.lo), static_cast<Wide>(i.hi)); 
+    };
+
+    switch(ins_type) {
+        case InsType::Add:
+            return saturate(Wide{a.lo} + b.lo, Wide{a.hi} + b.hi);
+        case InsType::Multiply:
+        {
+            const std::array<Wide, 4> corners{ Wide{a.lo} * b.lo, Wide{a.lo} * b.hi, Wide{a.hi} * b.lo, Wide{a.hi} * b.hi };
+            return saturate(*std::min_element(corners.begin(), corners.end()), *std::max_element(corners.begin(), corners.end()));
+        }
+        case InsType::Divide:
+        {
+            if (b.lo <= 0 && b.hi >= 0)
+            {
+                // divisor may be 0 (invalid program) or change sign, only |a/b| <= |a| holds
+                return saturate(-abs_max(a), abs_max(a));
+            }
+            // division truncates towards zero and is monotone in each operand for a divisor of constant sign
+            const std::array<Wide, 4> corners{ Wide{a.lo} / b.lo, Wide{a.lo} / b.hi, Wide{a.hi} / b.lo, Wide{a.hi} / b.hi };
+            return saturate(*std::min_element(corners.begin(), corners.end()), *std::max_element(corners.begin(), corners.end()));
+        }
+        case InsType::Modulo:
+        {
+            if (b.lo == b.hi && b.lo != 0 && a.lo >= 0)
+            {
+                const Wide mod = b.lo < 0 ? -Wide{b.lo} : Wide{b.lo};
+                if (Wide{a.hi} - a.lo < mod && a.lo % mod <= a.hi % mod)
+                {
+                    return saturate(a.lo % mod, a.hi % mod);
+                }
+            }
+            // the remainder has the sign of a and is smaller than |b| and not larger than |a|
+            const Wide max_rem = std::max(abs_max(b) - 1, Wide{0});
+            const Wide lo = a.lo >= 0 ? Wide{0} : -std::min(max_rem, -Wide{a.lo});
+            const Wide hi = a.hi <= 0 ? Wide{0} : std::min(max_rem, Wide{a.hi});
+            return saturate(lo, hi);
+        }
+        case InsType::Equal:
+            if (a.lo == a.hi && b.lo == b.hi && a.lo == b.lo)
+            {
+                return { 1, 1 };
+            }
+            return a.intersects(b) ? Interval{ 0, 1 } : Interval{ 0, 0 };
+        default:
+            throw std::runtime_error("Unknown instruction type detected!");
+    }
+}
+
 std::vector<IntermediateState> reduce_valid_states(int pos, std::vector<IntermediateState> &valid_states, const std::vector<Instruction> &ins_vec)
 {
     std::vector<IntermediateState> new_valid_states;
 
-    // retrieve <Val> of "add x <Val>" in fourth instruction
-    int val_x = std::stoi(ins_vec[4].b);
+    // retrieve <Val> of "add x <Val>" (inp w, mul x 0, add x z, mod x 26, div z <1|26>, add x <Val>)
+    int64_t val_x = ins_vec[5].b.imm;
 
     for (auto &state : valid_states)
     {
@@ -195,35 +470,34 @@ std::vector<IntermediateState> reduce_valid_states(int pos, std::vector<Intermed
     return new_valid_states;
 }
 
-std::vector<ValidWZPair> get_valid_z_values(int z, const std::vector<Instruction> &ins_vec)
+std::vector<IntermediateState> expand_valid_states(const std::vector<IntermediateState> &valid_states, const std::vector<Instruction> &ins_vec)
 {
-    std::vector<ValidWZPair> valid_pairs;
+    std::vector<IntermediateState> new_valid_states;
+    new_valid_states.reserve(9 * valid_states.size());
+    BatchALU alu{};
+    std::vector<int64_t> z_vec;
+    z_vec.reserve(valid_states.size());
+    for (const auto &state : valid_states)
+    {
+        z_vec.push_back(state.z);
+    }
 
     for (int w=1; w < 10; ++w)
     {
-        ALU alu{};
-        alu.vars['w'] = w;
-        alu.vars['z'] = z;
-        for (const auto &ins : ins_vec) 
+        alu.reset(z_vec);
+        alu.run(ins_vec, w);
+        const std::vector<int64_t> &new_z_vec = alu.regs[reg_idx('z')];
+        for (size_t i=0; i < valid_states.size(); ++i)
         {
-            if (ins.b.length() == 1 && ins.b[0] >= 'w' && ins.b[0] <= 'z')
-            {
-                alu.do_instruction(ins.a, ins.b[0], ins.ins_type);
-            }
-            else
-            {
-                int val_b = std::stoi(ins.b);
-                alu.do_instruction(ins.a, val_b, ins.ins_type);
-            }
+            new_valid_states.push_back({ valid_states[i].i_model_num * 10 + w, new_z_vec[i] });
         }
-        valid_pairs.push_back({ w,alu.vars['z'] });
     }
-    return valid_pairs;
+    return new_valid_states;
 }
 
 bool does_contain_divide_26(const std::vector<Instruction> &ins_vec)
 {
-    const Instruction division26{InsType::Divide, 'z', "26"};
+    const Instruction division26{InsType::Divide, reg_idx('z'), {false, 0, 26}};
     for (const auto &ins : ins_vec)
     {
         if (division26 == ins) return true;
@@ -231,70 +505,168 @@ bool does_contain_divide_26(const std::vector<Instruction> &ins_vec)
     return false;
 }
 
-
-void ALU::do_instruction(char a, char b, InsType ins_type) {
-    int b_int{ 0 };
-    // distinguish between b being a number and b being a variable w,x,y,z
-    if (auto res = vars.find(b); res != vars.end())
-    {
-        b_int = res->second;
-    }
-    else
+/**
+ * @brief Executes a block of instructions, each inp instruction reads input
+ * 
+ * @param ins_vec 
+ * @param input 
+ */
+void ALU::run(const std::vector<Instruction> &ins_vec, const int64_t input)
+{
+    for (const auto &ins : ins_vec) 
     {
-        if (!std::isdigit(static_cast<unsigned char>(b)))
-        {
-            throw std::invalid_argument("Trying to convert non-digit char to digit!");
-        }
-        b_int = b - '0';
+        do_instruction(ins, input);
     }
-    do_instruction(a, b_int, ins_type);
 }
 
-void ALU::do_instruction(char a, int b, InsType ins_type) {
+void ALU::do_instruction(const Instruction &ins, const int64_t input) {
+    int64_t &a = regs[ins.a];
+    const int64_t b = ins.b.is_reg ? regs[ins.b.reg] : ins.b.imm;
 
-    switch(ins_type) {
-        // case InsType::Input:
-            
-        //     break;
+    switch(ins.ins_type) {
+        case InsType::Input:
+            a = input;
+            break;
         case InsType::Add:
-            vars.at(a) += b;
+            a += b;
             break;
         case InsType::Multiply:
-            vars.at(a) *= b;
+            a *= b;
             break;
         case InsType::Divide:
-            vars.at(a) /= b;
+            a /= b;
             break;
         case InsType::Modulo:
-            vars.at(a) %= b;
+            a %= b;
             break;
         case InsType::Equal:
-            vars.at(a) = vars.at(a) == b ? 1 : 0;
+            a = a == b ? 1 : 0;
             break;
         default:
             throw std::runtime_error("Unknown instruction type detected!");
     }
 }
 
+/**
+ * @brief Creates one lane per z value, all other registers are set to 0
+ * 
+ * @param z_vec 
+ */
+void BatchALU::reset(const std::vector<int64_t> &z_vec)
+{
+    for (auto &reg : regs)
+    {
+        reg.assign(z_vec.size(), 0);
+    }
+    regs[reg_idx('z')] = z_vec;
+}
+
+/**
+ * @brief Executes a block of instructions on all lanes, each inp instruction reads the same input for all lanes
+ * 
+ * @param ins_vec 
+ * @param input 
+ */
+void BatchALU::run(const std::vector<Instruction> &ins_vec, const int64_t input)
+{
+    for (const auto &ins : ins_vec)
+    {
+        switch(ins.ins_type) {
+            case InsType::Input:
+                std::fill(regs[ins.a].begin(), regs[ins.a].end(), input);
+                break;
+            case InsType::Add:
+                apply(ins, [](int64_t a, int64_t b){ return a + b; });
+                break;
+            case InsType::Multiply:
+                apply(ins, [](int64_t a, int64_t b){ return a * b; });
+                break;
+            case InsType::Divide:
+                apply(ins, [](int64_t a, int64_t b){ return a / b; });
+                break;
+            case InsType::Modulo:
+                apply(ins, [](int64_t a, int64_t b){ return a % b; });
+                break;
+            case InsType::Equal:
+                apply(ins, [](int64_t a, int64_t b){ return static_cast<int64_t>(a == b); });
+                break;
+            default:
+                throw std::runtime_error("Unknown instruction type detected!");
+        }
+    }
+}
+
+/**
+ * @brief a = op(a, b) for all lanes, the branch on the operand kind is hoisted out of the loop
+ * 
+ * @tparam Op binary operation on int64_t
+ * @param ins 
+ * @param op 
+ */
+template<typename Op>
+void BatchALU::apply(const Instruction &ins, Op op)
+{
+    int64_t *a = regs[ins.a].data();
+    const size_t num_lanes = regs[ins.a].size();
+    if (ins.b.is_reg)
+    {
+        const int64_t *b = regs[ins.b.reg].data();
+        for (size_t i=0; i < num_lanes; ++i)
+        {
+            a[i] = op(a[i], b[i]);
+        }
+    }
+    else
+    {
+        const int64_t b = ins.b.imm;
+        for (size_t i=0; i < num_lanes; ++i)
+        {
+            a[i] = op(a[i], b);
+        }
+    }
+}
+
+/**
+ * @brief decodes the second operand of an instruction (register char or integer)
+ * 
+ * @param str 
+ * @return Operand 
+ */
+Operand parse_operand(const std::string &str)
+{
+    if (str.length() == 1 && str[0] >= 'w' && str[0] <= 'z')
+    {
+        return { true, reg_idx(str[0]), 0 };
+    }
+    return { false, 0, std::stoll(str) };
+}
+
 std::vector<std::vector<Instruction>> read_data(const std::string &file_path)
 {
     std::vector<std::string> str_vec = read_string_vec_from_file(file_path);
     std::vector<std::vector<Instruction>> ins_vec;
-    std::vector<Instruction> tmp_vec;
 
     for (const auto &str : str_vec)
     {
+        if (str.empty())
+        {
+            continue;
+        }
         std::vector<std::string> sub_str = split_string(str," ");
         InsType type = type_map.at(sub_str[0]);
 
         if (type == InsType::Input)
         {
-            ins_vec.push_back({});
+            ins_vec.push_back({ Instruction{ type, reg_idx(sub_str[1][0]), {} } });
         }
         else
         {
-            ins_vec.back().push_back(Instruction{ type, sub_str[1][0], sub_str[2]});
+            if (ins_vec.empty())
+            {
+                throw std::invalid_argument("Program has to start with an inp instruction!");
+            }
+            ins_vec.back().push_back(Instruction{ type, reg_idx(sub_str[1][0]), parse_operand(sub_str[2]) });
         }
     }
     return ins_vec;
-}
\ No newline at end of file
+}
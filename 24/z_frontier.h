@@ -0,0 +1,139 @@
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Search frontier of the digit search, maps each distinct z value to the smallest and largest
+ * model number prefix reaching it. Implemented as open addressing hash map with linear probing,
+ * so memory is bounded by the number of distinct z values.
+ */
+class ZFrontier
+{
+public:
+    struct Entry {
+        int64_t z{ EMPTY }; ///< z value or EMPTY for an unused slot
+        std::uint64_t min_prefix{ 0 }; ///< smallest model number prefix reaching z
+        std::uint64_t max_prefix{ 0 }; ///< largest model number prefix reaching z
+    };
+
+    explicit ZFrontier(const size_t expected_size = 16u);
+    size_t size() const;
+    void insert(const int64_t z, const std::uint64_t min_prefix, const std::uint64_t max_prefix);
+    const Entry *find(const int64_t z) const;
+    template<typename Func>
+    void for_each(Func func) const;
+
+private:
+    static constexpr int64_t EMPTY = std::numeric_limits<int64_t>::min();
+
+    size_t slot_of(const int64_t z) const;
+    void grow();
+
+    std::vector<Entry> m_slots; ///< capacity is always a power of two
+    size_t m_size;
+};
+
+ZFrontier::ZFrontier(const size_t expected_size) : m_size{ 0 }
+{
+    size_t capacity{ 16u };
+    while (capacity < 2u * expected_size)
+    {
+        capacity *= 2u;
+    }
+    m_slots.resize(capacity);
+}
+
+size_t ZFrontier::size() const
+{
+    return m_size;
+}
+
+/**
+ * @brief Adds z with the given prefixes or widens the [min, max] prefixes of an already stored z
+ *
+ * @param z must not be std::numeric_limits<int64_t>::min()
+ * @param min_prefix
+ * @param max_prefix
+ */
+void ZFrontier::insert(const int64_t z, const std::uint64_t min_prefix, const std::uint64_t max_prefix)
+{
+    if (2u * (m_size + 1u) > m_slots.size())
+    {
+        grow();
+    }
+    Entry &entry = m_slots[slot_of(z)];
+    if (entry.z == EMPTY)
+    {
+        entry = { z, min_prefix, max_prefix };
+        ++m_size;
+        return;
+    }
+    if (min_prefix < entry.min_prefix)
+    {
+        entry.min_prefix = min_prefix;
+    }
+    if (max_prefix > entry.max_prefix)
+    {
+        entry.max_prefix = max_prefix;
+    }
+}
+
+/**
+ * @brief Looks up z
+ *
+ * @param z
+ * @return const Entry* entry of z or nullptr if z is not part of the frontier
+ */
+const ZFrontier::Entry *ZFrontier::find(const int64_t z) const
+{
+    const Entry &entry = m_slots[slot_of(z)];
+    return entry.z == EMPTY ? nullptr : &entry;
+}
+
+template<typename Func>
+void ZFrontier::for_each(Func func) const
+{
+    for (const auto &entry : m_slots)
+    {
+        if (entry.z != EMPTY)
+        {
+            func(entry);
+        }
+    }
+}
+
+/**
+ * @brief Returns the slot holding z or the empty slot where z would be inserted
+ *
+ * @param z
+ * @return size_t
+ */
+size_t ZFrontier::slot_of(const int64_t z) const
+{
+    // splitmix64 finalizer, z values of neighbouring states differ only in the low bits
+    std::uint64_t hash = static_cast<std::uint64_t>(z);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+
+    const size_t mask = m_slots.size() - 1u;
+    size_t slot = static_cast<size_t>(hash) & mask;
+    while (m_slots[slot].z != EMPTY && m_slots[slot].z != z)
+    {
+        slot = (slot + 1u) & mask;
+    }
+    return slot;
+}
+
+void ZFrontier::grow()
+{
+    std::vector<Entry> old_slots(2u * m_slots.size());
+    std::swap(old_slots, m_slots);
+    for (const auto &entry : old_slots)
+    {
+        if (entry.z != EMPTY)
+        {
+            m_slots[slot_of(entry.z)] = entry;
+        }
+    }
+}
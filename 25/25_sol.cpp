@@ -3,6 +3,7 @@
 #include <ostream>
 
 #include "../utility.h"
+#include "cucumber_herd.h"
 
 using Elem = char;
 
@@ -30,6 +31,18 @@ void print_sea_floor(std::ostream &out, const std::vector<std::vector<Elem>> &se
 
 
 std::uint64_t day_25_1(const std::string &file_path)
+{
+    CucumberHerd herd{read_2d_vec_from_file<char>(file_path), EAST, SOUTH};
+    return herd.steps_until_gridlock();
+}
+
+/**
+ * @brief In-place reference implementation of day_25_1 on the char grid
+ * 
+ * @param file_path 
+ * @return std::uint64_t number of the first step without movement
+ */
+std::uint64_t day_25_1_in_place(const std::string &file_path)
 {
     std::vector<std::vector<Elem>> sea_floor = read_2d_vec_from_file<char>(file_path);
     // extend_sea_floor(sea_floor);
@@ -0,0 +1,219 @@
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Sea cucumber herd stored as two bitmasks (east and south facing), one bit per position, rows packed into 64 bit words.
+ * Each phase is computed with whole-row shift and mask operations into a second buffer, so no cucumber can move twice.
+ */
+class CucumberHerd
+{
+public:
+    CucumberHerd(const std::vector<std::vector<char>> &sea_floor, const char east, const char south);
+    std::uint64_t step();
+    std::uint64_t steps_until_gridlock();
+    void print(std::ostream &out) const;
+
+private:
+    using Word = std::uint64_t;
+    static constexpr size_t WORD_BITS = 64u;
+
+    std::uint64_t move_east();
+    std::uint64_t move_south();
+    void rotate_towards_high(const Word *in, Word *out) const;
+    void rotate_towards_low(const Word *in, Word *out) const;
+    bool get_bit(const std::vector<Word> &mask, const size_t row, const size_t col) const;
+
+    const char m_east_char;
+    const char m_south_char;
+    size_t m_rows;
+    size_t m_cols;
+    size_t m_words_per_row;
+    Word m_last_word_mask; ///< valid bits of the last word of each row
+    std::vector<Word> m_east; ///< row-major, bit c%64 of word c/64 is column c
+    std::vector<Word> m_south;
+    std::vector<Word> m_next; ///< output buffer of the running phase
+    std::vector<Word> m_movers; ///< cucumbers that move in the running phase
+    std::vector<Word> m_occupied; ///< scratch row
+    std::vector<Word> m_shifted; ///< scratch row
+};
+
+CucumberHerd::CucumberHerd(const std::vector<std::vector<char>> &sea_floor, const char east, const char south)
+    : m_east_char{ east }, m_south_char{ south }, m_rows{ sea_floor.size() }, m_cols{ sea_floor.empty() ? 0u : sea_floor[0].size() }
+{
+    if (m_rows == 0u || m_cols == 0u)
+    {
+        throw std::invalid_argument("Sea floor must not be empty!");
+    }
+    m_words_per_row = (m_cols + WORD_BITS - 1u) / WORD_BITS;
+    size_t last_bits = m_cols % WORD_BITS;
+    m_last_word_mask = last_bits == 0u ? ~Word{0u} : (Word{1u} << last_bits) - 1u;
+    m_east.assign(m_rows * m_words_per_row, 0u);
+    m_south.assign(m_rows * m_words_per_row, 0u);
+    m_next.assign(m_rows * m_words_per_row, 0u);
+    m_movers.assign(m_rows * m_words_per_row, 0u);
+    m_occupied.assign(m_words_per_row, 0u);
+    m_shifted.assign(m_words_per_row, 0u);
+    for (size_t row=0; row < m_rows; ++row)
+    {
+        if (sea_floor[row].size() != m_cols)
+        {
+            throw std::invalid_argument("Rows of sea floor differ in length!");
+        }
+        for (size_t col=0; col < m_cols; ++col)
+        {
+            Word bit = Word{1u} << (col % WORD_BITS);
+            size_t idx = row * m_words_per_row + col / WORD_BITS;
+            if (sea_floor[row][col] == east)
+            {
+                m_east[idx] |= bit;
+            }
+            else if (sea_floor[row][col] == south)
+            {
+                m_south[idx] |= bit;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Moves the east facing herd and afterwards the south facing herd
+ *
+ * @return std::uint64_t number of moved cucumbers
+ */
+std::uint64_t CucumberHerd::step()
+{
+    std::uint64_t num_moves = move_east();
+    return num_moves + move_south();
+}
+
+/**
+ * @brief Executes steps until no cucumber moves anymore
+ *
+ * @return std::uint64_t number of the first step without movement
+ */
+std::uint64_t CucumberHerd::steps_until_gridlock()
+{
+    std::uint64_t num_steps{ 1u };
+    while (step() > 0u)
+    {
+        ++num_steps;
+    }
+    return num_steps;
+}
+
+std::uint64_t CucumberHerd::move_east()
+{
+    std::uint64_t num_moves{ 0u };
+    for (size_t row=0; row < m_rows; ++row)
+    {
+        const Word *east = &m_east[row * m_words_per_row];
+        const Word *south = &m_south[row * m_words_per_row];
+        Word *movers = &m_movers[row * m_words_per_row];
+        Word *next = &m_next[row * m_words_per_row];
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            m_occupied[word] = east[word] | south[word];
+        }
+        rotate_towards_low(m_occupied.data(), m_shifted.data()); // bit c: position c+1 occupied
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            movers[word] = east[word] & ~m_shifted[word];
+            num_moves += static_cast<std::uint64_t>(__builtin_popcountll(movers[word]));
+        }
+        rotate_towards_high(movers, m_shifted.data()); // new positions of the movers
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            next[word] = (east[word] & ~movers[word]) | m_shifted[word];
+        }
+    }
+    std::swap(m_east, m_next);
+    return num_moves;
+}
+
+std::uint64_t CucumberHerd::move_south()
+{
+    std::uint64_t num_moves{ 0u };
+    for (size_t row=0; row < m_rows; ++row)
+    {
+        size_t row_below = row + 1u == m_rows ? 0u : row + 1u;
+        const Word *south = &m_south[row * m_words_per_row];
+        const Word *east_below = &m_east[row_below * m_words_per_row];
+        const Word *south_below = &m_south[row_below * m_words_per_row];
+        Word *movers = &m_movers[row * m_words_per_row];
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            movers[word] = south[word] & ~(east_below[word] | south_below[word]);
+            num_moves += static_cast<std::uint64_t>(__builtin_popcountll(movers[word]));
+        }
+    }
+    for (size_t row=0; row < m_rows; ++row)
+    {
+        size_t row_above = row == 0u ? m_rows - 1u : row - 1u;
+        const Word *south = &m_south[row * m_words_per_row];
+        const Word *movers = &m_movers[row * m_words_per_row];
+        const Word *movers_above = &m_movers[row_above * m_words_per_row];
+        Word *next = &m_next[row * m_words_per_row];
+        for (size_t word=0; word < m_words_per_row; ++word)
+        {
+            next[word] = (south[word] & ~movers[word]) | movers_above[word];
+        }
+    }
+    std::swap(m_south, m_next);
+    return num_moves;
+}
+
+/**
+ * @brief Rotates a row by one column towards higher columns, the last column wraps around to column 0
+ *
+ * @param in
+ * @param out
+ */
+void CucumberHerd::rotate_towards_high(const Word *in, Word *out) const
+{
+    const size_t last = m_words_per_row - 1u;
+    Word wrapped = (in[last] >> ((m_cols - 1u) % WORD_BITS)) & 1u;
+    for (size_t word=last; word > 0u; --word)
+    {
+        out[word] = (in[word] << 1) | (in[word-1u] >> (WORD_BITS-1u));
+    }
+    out[0] = (in[0] << 1) | wrapped;
+    out[last] &= m_last_word_mask;
+}
+
+/**
+ * @brief Rotates a row by one column towards lower columns, column 0 wraps around to the last column
+ *
+ * @param in
+ * @param out
+ */
+void CucumberHerd::rotate_towards_low(const Word *in, Word *out) const
+{
+    const size_t last = m_words_per_row - 1u;
+    Word wrapped = in[0] & 1u;
+    for (size_t word=0; word < last; ++word)
+    {
+        out[word] = (in[word] >> 1) | (in[word+1u] << (WORD_BITS-1u));
+    }
+    out[last] = (in[last] >> 1) | (wrapped << ((m_cols - 1u) % WORD_BITS));
+}
+
+bool CucumberHerd::get_bit(const std::vector<Word> &mask, const size_t row, const size_t col) const
+{
+    return (mask[row * m_words_per_row + col / WORD_BITS] >> (col % WORD_BITS)) & 1u;
+}
+
+void CucumberHerd::print(std::ostream &out) const
+{
+    for (size_t row=0; row < m_rows; ++row)
+    {
+        for (size_t col=0; col < m_cols; ++col)
+        {
+            out << (get_bit(m_east, row, col) ? m_east_char : (get_bit(m_south, row, col) ? m_south_char : '.'));
+        }
+        out << "\n";
+    }
+    out << "\n";
+}
@@ -99,6 +99,7 @@ int main(){
     // // Day 12
     // const std::string cavern_connections{"12/cave_connections.txt"};
     // std::cout << "Day 12: Number of paths: " << get_num_paths(cavern_connections) << std::endl;
+    // std::cout << "Day 12: Number of enumerated paths (4 threads): " << calc_paths_parallel(read_cavern_map(cavern_connections), 4u) << std::endl;
 
     // // Day 13
     // const std::string camera_code{"13/camera_code.txt"};
@@ -112,11 +113,15 @@ int main(){
     // const std::string chitons{"15/chitons_layout.txt"};
     // std::cout << "Day 15: Lowest Risk: " << calc_lowest_risk(chitons) << std::endl;
     // std::cout << "Day 15: Lowest Risk: " << calc_lowest_risk_2(chitons) << std::endl;
+    // SearchStats stats{};
+    // std::cout << "Day 15: Lowest Risk (bidirectional): " << calc_lowest_risk_2(chitons, 5u, SearchMode::BIDIRECTIONAL, stats) << ", expanded points: " << stats.num_expanded << std::endl;
+    // check_queue_engines(); // throws if any search mode or queue differs from plain Dijkstra
 
     // // Day 16
     // const std::string bits_data{"16/BITS_data.txt"};
     // std::cout << "Accumulated version number: " << acc_version_num(bits_data) << std::endl;
     // std::cout << "Calculated result: " << calc_packet_res(bits_data) << std::endl;
+    // std::cout << "Calculated result (streaming): " << calc_packet_res_streaming(bits_data) << std::endl;
 
     // //Day 17    
     // std::cout << "Highest trajectory point: " << get_highest_traj_pt("17/target_area.txt") << std::endl;
@@ -127,18 +132,25 @@ int main(){
 
     // //Day 19 
     // get_number_of_beacons("19/scanner_data.txt");
+    // get_number_of_beacons("19/scanner_data.txt", 4u);
+    // get_number_of_beacons("19/scanner_data.txt", 1u, AlignmentMode::INCREMENTAL);
 
     // // Day 20
     // std::cout << "Num lit pixels after 2 iterations: " << day_20_1("20/input_image.txt") << std::endl;
     // std::cout << "Num lit pixels after 50 iterations: " << day_20_2("20/input_image.txt") << std::endl;
+    // std::cout << "Num lit pixels after 50 iterations (4 threads): " << enhance_image("20/input_image.txt", 50u, 4u) << std::endl;
     
     // // Day21
     // std::cout << "Score loosing player x die rolls: " << day_21_1("21/starting_pos.txt") << std::endl;
     // std::cout << "Num universes of max wins: " << day_21_2("21/starting_pos.txt") << std::endl;    
+    // std::cout << "Num universes of max wins (win at 40, 20 spaces): " << day_21_2("21/starting_pos.txt", 40u, 20u, 3u) << std::endl; // throws if the universes exceed 64 bit
 
     // // Day22
     // std::cout << "22_1: " << day_22_1("22/data.txt") << std::endl;
+    // std::cout << "22_1 (region -N..N): " << day_22_1("22/data.txt", 50) << std::endl;
+    // std::cout << "22_1 (region from stdin, \"N\" or \"x=a..b,y=c..d,z=e..f\"): " << day_22_1("22/data.txt", std::cin) << std::endl;
     // std::cout << "22_2: " << day_22_2("22/data.txt") << std::endl;
+    // std::cout << "22_2 (signed volumes): " << day_22_2("22/data.txt", RebootEngine::SIGNED_VOLUMES) << std::endl;
 
     // Day23 was done on paper
 
@@ -146,6 +158,8 @@ int main(){
     // auto res = day_24_1_2("24/data.txt");
     // std::cout << "24_1: " << res.second << std::endl;
     // std::cout << "24_2: " << res.first << std::endl;
+    // auto res_generic = day_24_1_2("24/data.txt", MonadSolver::Z_FRONTIER);
+    // std::cout << "24_1 (z frontier): " << res_generic.second << std::endl;
 
     // Day25
     std::cout << "25_1: " << day_25_1("25/data.txt") << std::endl;
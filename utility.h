@@ -3,6 +3,16 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 
 template<typename T>
@@ -281,6 +291,64 @@ std::vector<std::vector<char>> read_2d_vec_from_file(const std::string& file_pat
     return char_vec_2d;
 }
 
+/**
+ * @brief Heap-backed 2D grid with runtime size. Entries are stored contiguously in row-major order
+ * 
+ * @tparam T type of a grid cell
+ */
+template<typename T>
+class Grid2D
+{
+public:
+    Grid2D() : m_rows{0}, m_cols{0}, m_data{} {};
+    Grid2D(const size_t rows, const size_t cols, const T &init_val = T{}) : m_rows{rows}, m_cols{cols}, m_data(rows*cols, init_val) {};
+
+    size_t rows() const { return m_rows; };
+    size_t cols() const { return m_cols; };
+    size_t size() const { return m_data.size(); };
+    size_t index(const size_t row, const size_t col) const { return row * m_cols + col; };
+
+    T& operator()(const size_t row, const size_t col) { return m_data[index(row, col)]; };
+    const T& operator()(const size_t row, const size_t col) const { return m_data[index(row, col)]; };
+    T& operator[](const size_t idx) { return m_data[idx]; };
+    const T& operator[](const size_t idx) const { return m_data[idx]; };
+
+private:
+    size_t m_rows;
+    size_t m_cols;
+    std::vector<T> m_data;
+};
+
+/**
+ * @brief Reads in a 2D map, containing only numbers without delimiters, into a runtime-sized grid
+ * 
+ * @param file_path 
+ * @return Grid2D<T> 
+ */
+template<typename T>
+Grid2D<T> read_grid_from_file(const std::string& file_path)
+{
+    std::vector<std::vector<T>> number_vec_2d = read_2d_vec_from_file<T>(file_path);
+    while (!number_vec_2d.empty() && number_vec_2d.back().empty()) // ignore trailing empty lines
+    {
+        number_vec_2d.pop_back();
+    }
+    size_t num_cols = number_vec_2d.empty() ? 0u : number_vec_2d[0].size();
+    Grid2D<T> grid{number_vec_2d.size(), num_cols};
+    for (size_t row=0; row < number_vec_2d.size(); ++row)
+    {
+        if (number_vec_2d[row].size() != num_cols)
+        {
+            throw std::invalid_argument("Rows of 2D map in file " + file_path + " differ in length!");
+        }
+        for (size_t col=0; col < num_cols; ++col)
+        {
+            grid(row, col) = number_vec_2d[row][col];
+        }
+    }
+    return grid;
+}
+
 /**
  * @brief Reads in a file and copies content line by line to a vector of strings
  * 
@@ -375,6 +443,297 @@ std::uint64_t bool_vec_to_uint(const std::vector<bool> &bool_vec)
     return res;
 }
 
+/**
+ * @brief Static bounding volume hierarchy over axis-aligned 3D boxes with inclusive coordinate ranges.
+ * Box needs the members x, y, z, each with start and end (e.g. Cuboid of day 22) and has to be aggregate initializable.
+ * query returns the indices of all boxes that overlap the query box. The index stores its own copy of the boxes.
+ * 
+ * @tparam Box 
+ */
+template<typename Box>
+class BoxIndex
+{
+public:
+    explicit BoxIndex(std::vector<Box> boxes);
+    std::vector<size_t> query(const Box &box) const;
+    void query(const Box &box, std::vector<size_t> &result) const;
+
+private:
+    static constexpr size_t MAX_LEAF_SIZE = 4u;
+
+    struct Node
+    {
+        Box bounds;
+        size_t first; ///< leaf: first entry in m_box_ids, inner node: index of left child (right child follows the left subtree)
+        size_t count; ///< number of boxes of a leaf, 0 for inner nodes
+        size_t right; ///< index of right child of an inner node
+    };
+
+    size_t build(const size_t first, const size_t last);
+    static bool do_overlap(const Box &b1, const Box &b2);
+    static Box merge(const Box &b1, const Box &b2);
+
+    std::vector<Box> m_boxes;
+    std::vector<size_t> m_box_ids; ///< box indices, each leaf refers to a consecutive part
+    std::vector<Node> m_nodes;
+};
+
+template<typename Box>
+BoxIndex<Box>::BoxIndex(std::vector<Box> boxes) : m_boxes{std::move(boxes)}, m_box_ids(m_boxes.size()), m_nodes{}
+{
+    for (size_t i=0; i < m_box_ids.size(); ++i)
+    {
+        m_box_ids[i] = i;
+    }
+    if (!m_boxes.empty())
+    {
+        m_nodes.reserve(2u * m_boxes.size() / MAX_LEAF_SIZE + 1u);
+        build(0u, m_boxes.size());
+    }
+}
+
+/**
+ * @brief Recursively builds the subtree for the boxes m_box_ids[first, last) by splitting at the median of the longest axis
+ * 
+ * @return size_t index of the subtree root in m_nodes
+ */
+template<typename Box>
+size_t BoxIndex<Box>::build(const size_t first, const size_t last)
+{
+    Box bounds = m_boxes[m_box_ids[first]];
+    for (size_t i=first+1; i < last; ++i)
+    {
+        bounds = merge(bounds, m_boxes[m_box_ids[i]]);
+    }
+    size_t node_idx = m_nodes.size();
+    m_nodes.push_back({bounds, first, last - first, 0u});
+    if (last - first <= MAX_LEAF_SIZE)
+    {
+        return node_idx;
+    }
+
+    // split at the median center (start + end) of the longest axis
+    auto ext_x = bounds.x.end - bounds.x.start;
+    auto ext_y = bounds.y.end - bounds.y.start;
+    auto ext_z = bounds.z.end - bounds.z.start;
+    auto center = [ext_x, ext_y, ext_z](const Box &b) 
+    {
+        if (ext_x >= ext_y && ext_x >= ext_z) return b.x.start + b.x.end;
+        if (ext_y >= ext_z) return b.y.start + b.y.end;
+        return b.z.start + b.z.end;
+    };
+    size_t mid = first + (last - first) / 2u;
+    std::nth_element(m_box_ids.begin() + first, m_box_ids.begin() + mid, m_box_ids.begin() + last, 
+        [this, &center](const size_t a, const size_t b) { return center(m_boxes[a]) < center(m_boxes[b]); });
+
+    size_t left = build(first, mid);
+    size_t right = build(mid, last);
+    m_nodes[node_idx].first = left;
+    m_nodes[node_idx].count = 0u;
+    m_nodes[node_idx].right = right;
+    return node_idx;
+}
+
+template<typename Box>
+std::vector<size_t> BoxIndex<Box>::query(const Box &box) const
+{
+    std::vector<size_t> result;
+    query(box, result);
+    return result;
+}
+
+/**
+ * @brief Appends the indices of all boxes overlapping box to result (unordered)
+ * 
+ * @param box 
+ * @param result 
+ */
+template<typename Box>
+void BoxIndex<Box>::query(const Box &box, std::vector<size_t> &result) const
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+    std::vector<size_t> stack{0u};
+    while (!stack.empty())
+    {
+        const Node &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (!do_overlap(node.bounds, box))
+        {
+            continue;
+        }
+        if (node.count == 0u)
+        {
+            stack.push_back(node.first);
+            stack.push_back(node.right);
+            continue;
+        }
+        for (size_t i=node.first; i < node.first + node.count; ++i)
+        {
+            if (do_overlap(m_boxes[m_box_ids[i]], box))
+            {
+                result.push_back(m_box_ids[i]);
+            }
+        }
+    }
+}
+
+template<typename Box>
+bool BoxIndex<Box>::do_overlap(const Box &b1, const Box &b2)
+{
+    return !(b1.x.end < b2.x.start || b2.x.end < b1.x.start
+            || b1.y.end < b2.y.start || b2.y.end < b1.y.start
+            || b1.z.end < b2.z.start || b2.z.end < b1.z.start);
+}
+
+template<typename Box>
+Box BoxIndex<Box>::merge(const Box &b1, const Box &b2)
+{
+    return { { std::min(b1.x.start, b2.x.start), std::max(b1.x.end, b2.x.end) },
+             { std::min(b1.y.start, b2.y.start), std::max(b1.y.end, b2.y.end) },
+             { std::min(b1.z.start, b2.z.start), std::max(b1.z.end, b2.z.end) } };
+}
+
+/**
+ * @brief Reusable barrier for a fixed number of threads (C++17 replacement for std::barrier).
+ * The last thread arriving executes the completion function before all waiting threads are released.
+ */
+class Barrier
+{
+public:
+    Barrier(const size_t num_threads, std::function<void()> completion = [](){}) : m_num_threads{num_threads}, m_completion{completion} {};
+    void arrive_and_wait();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    const size_t m_num_threads;
+    size_t m_num_waiting{ 0 };
+    size_t m_generation{ 0 }; ///< incremented each time all threads arrived
+    std::function<void()> m_completion;
+};
+
+void Barrier::arrive_and_wait()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    size_t generation = m_generation;
+    if (++m_num_waiting == m_num_threads)
+    {
+        m_completion();
+        m_num_waiting = 0;
+        ++m_generation;
+        m_cond.notify_all();
+        return;
+    }
+    m_cond.wait(lock, [this, generation]() { return generation != m_generation; });
+}
+
+/**
+ * @brief Executes all tasks on num_threads threads (including the calling thread). Tasks are dealt round robin 
+ * into one deque per thread, each thread takes tasks from the back of its own deque and steals from the front 
+ * of the other deques once its own deque is empty. Tasks must not create new tasks.
+ *
+ * @tparam Task
+ * @param tasks 
+ * @param num_threads 
+ * @param worker called as worker(task, thread_idx), must be safe to call concurrently for different tasks. 
+ * If it throws, no further tasks are started and the first exception is rethrown after all threads are joined.
+ */
+template<typename Task>
+void run_work_stealing(std::vector<Task> tasks, const size_t num_threads, const std::function<void(Task&, const size_t)> &worker)
+{
+    if (num_threads == 0u)
+    {
+        throw std::invalid_argument("At least one thread is required!");
+    }
+    struct TaskDeque
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<TaskDeque> deques(num_threads);
+    for (size_t i=0; i < tasks.size(); ++i)
+    {
+        deques[i % num_threads].tasks.push_back(std::move(tasks[i]));
+    }
+
+    std::atomic<bool> stop{ false };
+    std::mutex error_mutex;
+    std::exception_ptr first_error;
+    auto run = [&](const size_t thread_idx)
+    {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            bool has_task{ false };
+            Task task{};
+            for (size_t i=0; i < num_threads && !has_task; ++i)
+            {
+                TaskDeque &deque = deques[(thread_idx + i) % num_threads];
+                std::lock_guard<std::mutex> lock{ deque.mutex };
+                if (!deque.tasks.empty())
+                {
+                    if (i == 0u) // own deque
+                    {
+                        task = std::move(deque.tasks.back());
+                        deque.tasks.pop_back();
+                    }
+                    else
+                    {
+                        task = std::move(deque.tasks.front());
+                        deque.tasks.pop_front();
+                    }
+                    has_task = true;
+                }
+            }
+            if (!has_task) // no task left anywhere, tasks are never added
+            {
+                return;
+            }
+            try
+            {
+                worker(task, thread_idx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{ error_mutex };
+                if (!first_error)
+                {
+                    first_error = std::current_exception();
+                }
+                stop = true;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    try
+    {
+        for (size_t thread_idx=1; thread_idx < num_threads; ++thread_idx)
+        {
+            workers.emplace_back(run, thread_idx);
+        }
+    }
+    catch (...) // thread creation failed, the running threads still have to be joined
+    {
+        stop = true;
+        for (auto &thread : workers)
+        {
+            thread.join();
+        }
+        throw;
+    }
+    run(0u);
+    for (auto &thread : workers)
+    {
+        thread.join();
+    }
+    if (first_error)
+    {
+        std::rethrow_exception(first_error);
+    }
+}
+
 std::ostream& bold_on(std::ostream& os)
 {
     return os << "\e[1m";